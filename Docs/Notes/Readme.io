@@ -29,6 +29,7 @@ vismf.usepersistentifstreams  (def:  true)
 vismf.usesynchronousreads     (def:  false)
 vismf.usedynamicsetselection  (def:  true)
 vismf.iobuffersize            (def:  VisMF::IO_Buffer_Size)
+vismf.compressiontolerance    (def:  0.0, lossless, for Compressed_v1  (5) )
 amr.plot_nfiles               (def:  64)
 amr.checkpoint_nfiles         (def:  64)
 amr.mffile_nstreams           (def:  1)
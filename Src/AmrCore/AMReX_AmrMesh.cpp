@@ -4,6 +4,7 @@
 #include <AMReX_Cluster.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
 #include <AMReX_Print.H>
 
 namespace amrex {
@@ -372,6 +373,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.queryAdd("check_input", check_input);
 
+    pp.queryAdd("use_distributed_clustering", use_distributed_clustering);
+
     finest_level = -1;
 
     if (check_input) checkInput();
@@ -682,10 +685,18 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         // Create initial cluster containing all tagged points.
         //
         Gpu::PinnedVector<IntVect> tagvec;
-        tags.collate(tagvec);
+        Long ntags;
+        if (use_distributed_clustering) {
+            tags.local_collate(tagvec);
+            ntags = tagvec.size();
+            ParallelAllReduce::Sum(ntags, ParallelContext::CommunicatorSub());
+        } else {
+            tags.collate(tagvec);
+            ntags = tagvec.size();
+        }
         tags.clear();
 
-        if (tagvec.size() > 0)
+        if (ntags > 0)
         {
             //
             // Created new level, now generate efficient grids.
@@ -694,7 +705,32 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
                 new_finest = std::max(new_finest,levf);
             }
 
-            if (levf > useFixedUpToLevel()) {
+            if (levf > useFixedUpToLevel() && use_distributed_clustering) {
+                //
+                // Cluster in chunks of the size of the largest new grids.
+                //
+                IntVect chunk_size;
+                for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+                    chunk_size[n] = std::max(1, max_grid_size[levf][n]
+                                             / (ref_ratio[levc][n]*bf_lev[levc][n]));
+                }
+                BoxList new_bx = DistributedCluster(tagvec.data(), tagvec.size(), chunk_size,
+                                                    grid_eff, use_new_chop, p_n_ba[levc]);
+                new_bx.refine(bf_lev[levc]);
+                new_bx.simplify();
+                if (new_bx.size()>0) {
+                    // Chop new grids outside domain
+                    new_bx.intersect(Geom(levc).Domain());
+                }
+
+                //
+                // Refine up to levf.
+                //
+                new_bx.refine(ref_ratio[levc]);
+                BL_ASSERT(new_bx.isDisjoint());
+
+                new_grids[levf] = BoxArray(std::move(new_bx), max_grid_size[levf]);
+            } else if (levf > useFixedUpToLevel()) {
                 BoxList new_bx;
                 if (ParallelDescriptor::IOProcessor()) {
                     BL_PROFILE("AmrMesh-cluster");
@@ -1044,6 +1080,7 @@ std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
     os << "  refine_grid_layout_dims = " << amr_mesh.refine_grid_layout_dims << "\n";
     os << "  check_input = " << amr_mesh.check_input  << "\n";
     os << "  use_new_chop = " << amr_mesh.use_new_chop << "\n";
+    os << "  use_distributed_clustering = " << amr_mesh.use_distributed_clustering << "\n";
     os << "  iterate_on_new_grids = " << amr_mesh.iterate_on_new_grids << "\n";
     return os;
 }
@@ -5,9 +5,13 @@
 #include <AMReX_Vector.H>
 #include <AMReX_Array.H>
 #include <AMReX_BLProfiler.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace amrex {
 
@@ -604,4 +608,186 @@ ClusterList::intersect (BoxArray& domba)
     domba.clear();
 }
 
+BoxList
+DistributedCluster (IntVect const* tags, Long ntags, IntVect const& chunk_size,
+                    Real eff, bool use_new_chop, BoxArray const& nesting_ba)
+{
+    BL_PROFILE("DistributedCluster()");
+
+    auto chunk_of = [&] (IntVect const& iv) { return amrex::coarsen(iv, chunk_size); };
+    auto by_chunk = [&] (IntVect const& a, IntVect const& b) { return chunk_of(a) < chunk_of(b); };
+
+    Vector<IntVect> ltags(tags, tags+ntags);
+    std::sort(ltags.begin(), ltags.end(), by_chunk);
+
+    //
+    // Local chunks with tags and their number of tags.
+    //
+    Vector<Box> chunks;
+    Vector<Long> lcount;
+    for (auto const& iv : ltags) {
+        IntVect c = chunk_of(iv);
+        if (chunks.empty() || chunks.back().smallEnd() != c) {
+            chunks.emplace_back(c, c);
+            lcount.push_back(0);
+        }
+        ++lcount.back();
+    }
+    Vector<Box> lchunks = chunks;
+
+    //
+    // All chunks with tags, sorted, and the number of tags in each of them.
+    //
+    AllGatherBoxes(chunks);
+    auto box_less = [] (Box const& a, Box const& b) { return a.smallEnd() < b.smallEnd(); };
+    std::sort(chunks.begin(), chunks.end(), box_less);
+    chunks.erase(std::unique(chunks.begin(), chunks.end()), chunks.end());
+    const int nchunks = static_cast<int>(chunks.size());
+
+    auto chunk_index = [&] (Box const& b) {
+        return static_cast<int>(std::lower_bound(chunks.begin(), chunks.end(), b, box_less)
+                                - chunks.begin());
+    };
+
+    Vector<Long> count(nchunks, 0);
+    for (int i = 0, N = static_cast<int>(lchunks.size()); i < N; ++i) {
+        count[chunk_index(lchunks[i])] += lcount[i];
+    }
+    ParallelAllReduce::Sum(count.data(), nchunks, ParallelContext::CommunicatorSub());
+
+    //
+    // Owners are contiguous ranges of chunks with about the same number of tags.
+    //
+    const int nprocs = ParallelContext::NProcsSub();
+    Long total = 0;
+    for (auto c : count) { total += c; }
+    Vector<int> owner(nchunks);
+    {
+        Long sum = 0;
+        for (int i = 0; i < nchunks; ++i) {
+            owner[i] = static_cast<int>((static_cast<double>(sum)*nprocs)
+                                        / static_cast<double>(total));
+            owner[i] = std::min(owner[i], nprocs-1);
+            sum += count[i];
+        }
+    }
+
+    //
+    // Send the tags to the owners of their chunks.
+    //
+    Vector<IntVect> rtags;
+#ifdef BL_USE_MPI
+    {
+        Vector<int> sendcnt(nprocs, 0);
+        Vector<int> dest(lchunks.size());
+        for (int i = 0, N = static_cast<int>(lchunks.size()); i < N; ++i) {
+            dest[i] = owner[chunk_index(lchunks[i])];
+            if (static_cast<Long>(sendcnt[dest[i]]) + lcount[i]*AMREX_SPACEDIM
+                > static_cast<Long>(std::numeric_limits<int>::max())) {
+                amrex::Abort("DistributedCluster: too many tags. Using a larger blocking factor might help.");
+            }
+            sendcnt[dest[i]] += static_cast<int>(lcount[i])*AMREX_SPACEDIM;
+        }
+
+        Vector<int> senddsp(nprocs, 0);
+        for (int i = 1; i < nprocs; ++i) {
+            senddsp[i] = senddsp[i-1] + sendcnt[i-1];
+        }
+
+        Vector<int> sendbuf(ltags.size()*AMREX_SPACEDIM);
+        {
+            Vector<int> pos = senddsp;
+            Long itag = 0;
+            for (int i = 0, N = static_cast<int>(lchunks.size()); i < N; ++i) {
+                for (Long n = 0; n < lcount[i]; ++n, ++itag) {
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        sendbuf[pos[dest[i]]++] = ltags[itag][idim];
+                    }
+                }
+            }
+        }
+        ltags.clear();
+        ltags.shrink_to_fit();
+
+        MPI_Comm comm = ParallelContext::CommunicatorSub();
+        Vector<int> recvcnt(nprocs);
+        BL_COMM_PROFILE(BLProfiler::Alltoall, sizeof(int),
+                        ParallelContext::MyProcSub(), BLProfiler::BeforeCall());
+        BL_MPI_REQUIRE( MPI_Alltoall(sendcnt.data(), 1,
+                                     ParallelDescriptor::Mpi_typemap<int>::type(),
+                                     recvcnt.data(), 1,
+                                     ParallelDescriptor::Mpi_typemap<int>::type(), comm) );
+        BL_COMM_PROFILE(BLProfiler::Alltoall, sizeof(int),
+                        ParallelContext::MyProcSub(), BLProfiler::AfterCall());
+
+        Vector<int> recvdsp(nprocs, 0);
+        Long nrecv = recvcnt[0];
+        for (int i = 1; i < nprocs; ++i) {
+            recvdsp[i] = recvdsp[i-1] + recvcnt[i-1];
+            nrecv += recvcnt[i];
+        }
+        if (nrecv > static_cast<Long>(std::numeric_limits<int>::max())) {
+            amrex::Abort("DistributedCluster: too many tags. Using a larger blocking factor might help.");
+        }
+
+        Vector<int> recvbuf(nrecv);
+        BL_COMM_PROFILE(BLProfiler::Alltoallv, sizeof(int),
+                        ParallelContext::MyProcSub(), BLProfiler::BeforeCall());
+        BL_MPI_REQUIRE( MPI_Alltoallv(sendbuf.data(), sendcnt.data(), senddsp.data(),
+                                      ParallelDescriptor::Mpi_typemap<int>::type(),
+                                      recvbuf.data(), recvcnt.data(), recvdsp.data(),
+                                      ParallelDescriptor::Mpi_typemap<int>::type(), comm) );
+        BL_COMM_PROFILE(BLProfiler::Alltoallv, sizeof(int),
+                        ParallelContext::MyProcSub(), BLProfiler::AfterCall());
+
+        rtags.resize(nrecv/AMREX_SPACEDIM);
+        for (Long n = 0, N = rtags.size(); n < N; ++n) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                rtags[n][idim] = recvbuf[n*AMREX_SPACEDIM+idim];
+            }
+        }
+    }
+#else
+    rtags = std::move(ltags);
+#endif
+
+    //
+    // Cluster each chunk.
+    //
+    std::sort(rtags.begin(), rtags.end(), by_chunk);
+
+    Vector<Box> bxs;
+    for (Long begin = 0, N = rtags.size(); begin < N; )
+    {
+        const IntVect c = chunk_of(rtags[begin]);
+        Long end = begin+1;
+        while (end < N && chunk_of(rtags[end]) == c) { ++end; }
+
+        ClusterList clist(rtags.data()+begin, end-begin);
+        if (use_new_chop) {
+            clist.new_chop(eff);
+        } else {
+            clist.chop(eff);
+        }
+        const Box chunk_box = amrex::refine(Box(c,c), chunk_size);
+        BoxArray chunk_nesting_ba = amrex::intersect(nesting_ba, chunk_box);
+        clist.intersect(chunk_nesting_ba);
+
+        for (auto const& b : clist.boxList()) {
+            bxs.push_back(b);
+        }
+
+        begin = end;
+    }
+
+    //
+    // The same clusters on all processes, in an order that does not depend
+    // on the number of processes.
+    //
+    AllGatherBoxes(bxs);
+    std::sort(bxs.begin(), bxs.end(), box_less);
+
+    return BoxList(std::move(bxs));
+}
+
 }
@@ -74,6 +74,7 @@ void InterpFaceRegister::define (BoxArray const& fba, DistributionMapping const&
         Orientation other_face = face.flip();
         auto const& cpc = m_face_mask[face].getCPC(IntVect(0), m_face_mask[other_face],
                                                    IntVect(0), m_fine_geom.periodicity());
+        FabArrayBase::CommCachePin cpc_pin(cpc);
         m_face_mask[face].setVal(fine_fine_face, cpc, 0, 1);
     }
 }
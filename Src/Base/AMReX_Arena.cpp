@@ -3,6 +3,7 @@
 #include <AMReX_BArena.H>
 #include <AMReX_CArena.H>
 #include <AMReX_PArena.H>
+#include <AMReX_SArena.H>
 
 #include <AMReX.H>
 #include <AMReX_Print.H>
@@ -34,7 +35,13 @@ namespace {
     Arena* the_pinned_arena = nullptr;
     Arena* the_cpu_arena = nullptr;
 
+#if defined(BL_COALESCE_FABS) || defined(AMREX_USE_GPU)
+    std::string the_arena_type = "CArena";
+#else
+    std::string the_arena_type = "BArena";
+#endif
     Long the_arena_init_size = 0L;
+    Long the_arena_max_small_size = SArena::DefaultMaxSmallSize;
     Long the_device_arena_init_size = 1024*1024*8;
     Long the_managed_arena_init_size = 1024*1024*8;
     Long the_pinned_arena_init_size = 1024*1024*8;
@@ -283,7 +290,9 @@ Arena::Initialize ()
 #endif
 
     ParmParse pp("amrex");
+    pp.queryAdd(        "the_arena_type",              the_arena_type);
     pp.queryAdd(        "the_arena_init_size",         the_arena_init_size);
+    pp.queryAdd(        "the_arena_max_small_size",    the_arena_max_small_size);
     pp.queryAdd( "the_device_arena_init_size",  the_device_arena_init_size);
     pp.queryAdd("the_managed_arena_init_size", the_managed_arena_init_size);
     pp.queryAdd( "the_pinned_arena_init_size",  the_pinned_arena_init_size);
@@ -295,22 +304,35 @@ Arena::Initialize ()
     pp.queryAdd("the_arena_is_managed", the_arena_is_managed);
     pp.queryAdd("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
 
+    if (the_arena_type == "CArena" || the_arena_type == "SArena")
     {
-#if defined(BL_COALESCE_FABS) || defined(AMREX_USE_GPU)
         ArenaInfo ai{};
         ai.SetReleaseThreshold(the_arena_release_threshold);
         if (the_arena_is_managed) {
-            the_arena = new CArena(0, ai.SetPreferred());
+            ai.SetPreferred();
         } else {
-            the_arena = new CArena(0, ai.SetDeviceMemory());
+            ai.SetDeviceMemory();
+        }
+        if (the_arena_type == "CArena") {
+            the_arena = new CArena(0, ai);
+        } else {
+            the_arena = new SArena(the_arena_max_small_size, ai);
         }
 #ifdef AMREX_USE_GPU
         void *p = the_arena->alloc(static_cast<std::size_t>(the_arena_init_size));
         the_arena->free(p);
 #endif
-#else
-        the_arena = The_BArena();
+    }
+    else if (the_arena_type == "BArena")
+    {
+#ifdef AMREX_USE_GPU
+        amrex::Abort("Arena::Initialize: amrex.the_arena_type = BArena is not supported for GPU builds");
 #endif
+        the_arena = The_BArena();
+    }
+    else
+    {
+        amrex::Abort("Arena::Initialize: unknown amrex.the_arena_type = " + the_arena_type);
     }
 
     the_async_arena = new PArena(the_async_arena_release_threshold);
@@ -398,24 +420,32 @@ Arena::PrintUsage ()
         CArena* p = dynamic_cast<CArena*>(The_Arena());
         if (p) {
             p->PrintUsage("The         Arena");
+        } else if (auto* q = dynamic_cast<SArena*>(The_Arena())) {
+            q->PrintUsage("The         Arena");
         }
     }
     if (The_Device_Arena() && The_Device_Arena() != The_Arena()) {
         CArena* p = dynamic_cast<CArena*>(The_Device_Arena());
         if (p) {
             p->PrintUsage("The  Device Arena");
+        } else if (auto* q = dynamic_cast<SArena*>(The_Device_Arena())) {
+            q->PrintUsage("The  Device Arena");
         }
     }
     if (The_Managed_Arena() && The_Managed_Arena() != The_Arena()) {
         CArena* p = dynamic_cast<CArena*>(The_Managed_Arena());
         if (p) {
             p->PrintUsage("The Managed Arena");
+        } else if (auto* q = dynamic_cast<SArena*>(The_Managed_Arena())) {
+            q->PrintUsage("The Managed Arena");
         }
     }
     if (The_Pinned_Arena()) {
         CArena* p = dynamic_cast<CArena*>(The_Pinned_Arena());
         if (p) {
             p->PrintUsage("The  Pinned Arena");
+        } else if (auto* q = dynamic_cast<SArena*>(The_Pinned_Arena())) {
+            q->PrintUsage("The  Pinned Arena");
         }
     }
 }
@@ -443,24 +473,32 @@ Arena::PrintUsageToFiles (const std::string& filename, const std::string& messag
         CArena* p = dynamic_cast<CArena*>(The_Arena());
         if (p) {
             p->PrintUsage(ofs, "The         Arena", "    ");
+        } else if (auto* q = dynamic_cast<SArena*>(The_Arena())) {
+            q->PrintUsage(ofs, "The         Arena", "    ");
         }
     }
     if (The_Device_Arena() && The_Device_Arena() != The_Arena()) {
         CArena* p = dynamic_cast<CArena*>(The_Device_Arena());
         if (p) {
             p->PrintUsage(ofs, "The  Device Arena", "    ");
+        } else if (auto* q = dynamic_cast<SArena*>(The_Device_Arena())) {
+            q->PrintUsage(ofs, "The  Device Arena", "    ");
         }
     }
     if (The_Managed_Arena() && The_Managed_Arena() != The_Arena()) {
         CArena* p = dynamic_cast<CArena*>(The_Managed_Arena());
         if (p) {
             p->PrintUsage(ofs, "The Managed Arena", "    ");
+        } else if (auto* q = dynamic_cast<SArena*>(The_Managed_Arena())) {
+            q->PrintUsage(ofs, "The Managed Arena", "    ");
         }
     }
     if (The_Pinned_Arena()) {
         CArena* p = dynamic_cast<CArena*>(The_Pinned_Arena());
         if (p) {
             p->PrintUsage(ofs, "The  Pinned Arena", "    ");
+        } else if (auto* q = dynamic_cast<SArena*>(The_Pinned_Arena())) {
+            q->PrintUsage(ofs, "The  Pinned Arena", "    ");
         }
     }
 
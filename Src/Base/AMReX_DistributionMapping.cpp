@@ -9,6 +9,7 @@
 #include <AMReX_VisMF.H>
 #include <AMReX_Utility.H>
 #include <AMReX_Morton.H>
+#include <AMReX_Machine.H>
 
 #include <iostream>
 #include <fstream>
@@ -25,6 +26,9 @@
 
 namespace {
 int flag_verbose_mapper;
+int graph_ngrow;
+amrex::Real graph_max_imbalance;
+int sfc_node_aware;
 }
 
 namespace amrex {
@@ -74,6 +78,9 @@ DistributionMapping::strategy (DistributionMapping::Strategy how)
     case RRSFC:
         m_BuildMap = &DistributionMapping::RRSFCProcessorMap;
         break;
+    case GRAPH:
+        m_BuildMap = &DistributionMapping::GraphProcessorMap;
+        break;
     default:
         amrex::Error("Bad DistributionMapping::Strategy");
     }
@@ -115,6 +122,9 @@ DistributionMapping::Initialize ()
     max_efficiency   = 0.9_rt;
     node_size        = 0;
     flag_verbose_mapper = 0;
+    graph_ngrow      = 1;
+    graph_max_imbalance = 1.05_rt;
+    sfc_node_aware   = 0;
 
     ParmParse pp("DistributionMapping");
 
@@ -124,6 +134,9 @@ DistributionMapping::Initialize ()
     pp.queryAdd("sfc_threshold",       sfc_threshold);
     pp.queryAdd("node_size",           node_size);
     pp.queryAdd("verbose_mapper",      flag_verbose_mapper);
+    pp.queryAdd("graph_ngrow",         graph_ngrow);
+    pp.queryAdd("graph_max_imbalance", graph_max_imbalance);
+    pp.queryAdd("sfc_node_aware",      sfc_node_aware);
 
     std::string theStrategy;
 
@@ -145,6 +158,10 @@ DistributionMapping::Initialize ()
         {
             strategy(RRSFC);
         }
+        else if (theStrategy == "GRAPH")
+        {
+            strategy(GRAPH);
+        }
         else
         {
             std::string msg("Unknown strategy: ");
@@ -1256,6 +1273,116 @@ Distribute (const std::vector<SFCToken>&     tokens,
 #endif
 }
 
+// Cut the boxes, which are in space filling curve order, into segments such
+// that segment i gets a share[i] fraction of the total weight.  A box goes to
+// the segment its weight midpoint falls in.
+static
+void
+DistributeByShare (const std::vector<int>&          sfc_boxes,
+                   const std::vector<Long>&         wgts,
+                   const std::vector<Real>&         share,
+                   std::vector< std::vector<int> >& v)
+{
+    const int nbuckets = share.size();
+    v.resize(nbuckets);
+
+    Real total = 0;
+    for (int ib : sfc_boxes) {
+        total += wgts[ib];
+    }
+
+    int i = 0;
+    Real bucket_end = share[0]*total;
+    Real cum = 0;
+    for (int ib : sfc_boxes)
+    {
+        const Real mid = cum + Real(0.5)*wgts[ib];
+        while (mid >= bucket_end && i < nbuckets-1) {
+            bucket_end += share[++i]*total;
+        }
+        v[i].push_back(ib);
+        cum += wgts[ib];
+    }
+}
+
+// Two-level space filling curve distribution.  The curve is first cut into
+// one segment per node weighted by the number of ranks on the node, and then
+// the segment of each node is cut into one segment per rank on that node.
+// node_ranks[i] holds the ranks on node i.  v is indexed by rank.
+static
+void
+DistributeNodeAware (const std::vector<SFCToken>&          tokens,
+                     const std::vector<Long>&              wgts,
+                     const std::vector<std::vector<int> >& node_ranks,
+                     std::vector< std::vector<int> >&      v)
+{
+    BL_PROFILE("DistributionMapping::DistributeNodeAware()");
+
+    const int nnodes = node_ranks.size();
+    int nprocs = 0;
+    for (auto const& nr : node_ranks) {
+        nprocs += nr.size();
+    }
+    v.clear();
+    v.resize(nprocs);
+
+    std::vector<int> sfc_boxes;
+    sfc_boxes.reserve(tokens.size());
+    for (auto const& t : tokens) {
+        sfc_boxes.push_back(t.m_box);
+    }
+
+    std::vector<Real> share(nnodes);
+    for (int inode = 0; inode < nnodes; ++inode) {
+        share[inode] = Real(node_ranks[inode].size()) / Real(nprocs);
+    }
+
+    std::vector< std::vector<int> > vnode;
+    DistributeByShare(sfc_boxes, wgts, share, vnode);
+
+    for (int inode = 0; inode < nnodes; ++inode)
+    {
+        auto const& ranks = node_ranks[inode];
+        const int nr = ranks.size();
+        std::vector< std::vector<int> > vrank;
+        DistributeByShare(vnode[inode], wgts, std::vector<Real>(nr, Real(1)/Real(nr)), vrank);
+        for (int j = 0; j < nr; ++j) {
+            v[ranks[j]] = std::move(vrank[j]);
+        }
+
+        if (flag_verbose_mapper) {
+            Print() << "  Node " << inode << " contains " << vnode[inode].size()
+                    << " boxes on " << nr << " ranks" << std::endl;
+        }
+    }
+}
+
+namespace {
+    // Ranks in the current subgroup grouped by node.  If node_size is
+    // positive, nodes are blocks of node_size consecutive ranks.
+    std::vector<std::vector<int> > getNodeRanks (int nprocs)
+    {
+        std::vector<std::vector<int> > r;
+        if (node_size > 0) {
+            for (int i = 0; i < nprocs; ++i) {
+                if (i % node_size == 0) r.emplace_back();
+                r.back().push_back(i);
+            }
+        } else {
+            const Vector<int> node_ids = machine::get_node_ids();
+            AMREX_ASSERT(node_ids.size() == nprocs);
+            std::map<int,std::vector<int> > node_map;
+            for (int i = 0; i < nprocs; ++i) {
+                node_map[node_ids[i]].push_back(i);
+            }
+            for (auto& kv : node_map) {
+                r.push_back(std::move(kv.second));
+            }
+        }
+        return r;
+    }
+}
+
 void
 DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
                                           const std::vector<Long>& wgts,
@@ -1304,6 +1431,18 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
     // Put'm in Morton space filling curve order.
     //
     std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+
+    if (sfc_node_aware)
+    {
+        auto node_ranks = getNodeRanks(nprocs);
+        if (node_ranks.size() > 1 && static_cast<int>(node_ranks.size()) < nprocs)
+        {
+            std::vector< std::vector<int> > vec;
+            DistributeNodeAware(tokens, wgts, node_ranks, vec);
+            NodeAwareMapDoIt(vec, wgts, node_ranks, sort, eff);
+            return;
+        }
+    }
     //
     // Split'm up as equitably as possible per team.
     //
@@ -1454,6 +1593,75 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
     }
 }
 
+void
+DistributionMapping::NodeAwareMapDoIt (const std::vector<std::vector<int> >& vec,
+                                       const std::vector<Long>&              wgts,
+                                       const std::vector<std::vector<int> >& node_ranks,
+                                       bool                                  sort,
+                                       Real*                                 eff)
+{
+    if (flag_verbose_mapper) {
+        Print() << "DM: NodeAwareMapDoIt called on " << node_ranks.size()
+                << " nodes" << std::endl;
+    }
+
+#if defined (BL_USE_TEAM)
+    amrex::Abort("Team support is not implemented yet in node aware SFC");
+#endif
+
+    const int nprocs = vec.size();
+
+    // Within a node, the heaviest segment goes to the least used rank.
+    Vector<int> usage_order(nprocs);
+    if (sort) {
+        Vector<int> ord;
+        LeastUsedCPUs(nprocs,ord);
+        for (int i = 0; i < nprocs; ++i) {
+            usage_order[ord[i]] = i;
+        }
+    } else {
+        std::iota(usage_order.begin(), usage_order.end(), 0);
+    }
+
+    Real sum_wgt = 0, max_wgt = 0;
+    for (auto const& ranks : node_ranks)
+    {
+        std::vector<LIpair> LIpairV;
+        std::vector<int> sorted_ranks = ranks;
+        for (int rank : ranks) {
+            Long wgt = 0;
+            for (int ib : vec[rank]) {
+                wgt += wgts[ib];
+            }
+            LIpairV.push_back(LIpair(wgt,rank));
+            sum_wgt += wgt;
+            max_wgt = std::max(max_wgt, static_cast<Real>(wgt));
+        }
+        if (sort) {
+            Sort(LIpairV, true);
+            std::sort(sorted_ranks.begin(), sorted_ranks.end(),
+                      [&] (int a, int b) { return usage_order[a] < usage_order[b]; });
+        }
+        for (int j = 0, nr = ranks.size(); j < nr; ++j) {
+            const int grank = ParallelContext::local_to_global_rank(sorted_ranks[j]);
+            for (int ib : vec[LIpairV[j].second]) {
+                m_ref->m_pmap[ib] = grank;
+            }
+        }
+    }
+
+    if (eff || verbose)
+    {
+        Real efficiency = sum_wgt/(nprocs*max_wgt);
+        if (eff) *eff = efficiency;
+
+        if (verbose)
+        {
+            amrex::Print() << "SFC (node aware) efficiency: " << efficiency << '\n';
+        }
+    }
+}
+
 void
 DistributionMapping::SFCProcessorMap (const BoxArray& boxes,
                                       int             nprocs)
@@ -1572,6 +1780,506 @@ DistributionMapping::RRSFCProcessorMap (const BoxArray&          boxes,
     RRSFCDoIt(boxes,nprocs);
 }
 
+namespace {
+
+    // Graph in compressed sparse row format.  The neighbors of vertex i
+    // are adjncy[xadj[i]] ... adjncy[xadj[i+1]-1] with edge weights in adjwgt.
+    struct BoxGraph
+    {
+        std::vector<Long> vwgt;
+        std::vector<int>  xadj;
+        std::vector<int>  adjncy;
+        std::vector<Long> adjwgt;
+
+        int nvtxs () const { return static_cast<int>(vwgt.size()); }
+    };
+
+    // The weight of the edge between two boxes is the number of ghost cells
+    // they exchange in both directions, i.e., the shared face area times
+    // the ghost width for face neighbors.
+    BoxGraph makeBoxGraph (const BoxArray& boxes, const std::vector<Long>& wgts,
+                           const IntVect& ngrow)
+    {
+        BL_PROFILE("makeBoxGraph()");
+
+        const int N = boxes.size();
+
+        std::vector<std::vector<std::pair<int,Long> > > nbrs(N);
+        std::vector< std::pair<int,Box> > isects;
+        for (int i = 0; i < N; ++i)
+        {
+            boxes.intersections(amrex::grow(boxes[i],ngrow), isects);
+            for (auto const& is : isects)
+            {
+                const int j = is.first;
+                if (j != i) {
+                    const Long w = is.second.numPts();
+                    nbrs[i].emplace_back(j,w);
+                    nbrs[j].emplace_back(i,w);
+                }
+            }
+        }
+
+        BoxGraph g;
+        g.vwgt.assign(wgts.begin(), wgts.end());
+        g.xadj.resize(N+1);
+        g.xadj[0] = 0;
+        for (int i = 0; i < N; ++i)
+        {
+            auto& nb = nbrs[i];
+            std::sort(nb.begin(), nb.end());
+            for (int k = 0, M = nb.size(); k < M; ++k)
+            {
+                if (k > 0 && nb[k].first == nb[k-1].first) {
+                    g.adjwgt.back() += nb[k].second;
+                } else {
+                    g.adjncy.push_back(nb[k].first);
+                    g.adjwgt.push_back(nb[k].second);
+                }
+            }
+            g.xadj[i+1] = g.adjncy.size();
+            std::vector<std::pair<int,Long> >().swap(nb);
+        }
+        return g;
+    }
+
+    // Heavy edge matching.  cmap maps the vertices of g to those of the
+    // coarse graph cg.  Returns false if the graph could not be coarsened
+    // substantially.
+    bool coarsenGraph (const BoxGraph& g, Long maxvwgt, BoxGraph& cg, std::vector<int>& cmap)
+    {
+        const int N = g.nvtxs();
+
+        std::vector<int> match(N, -1);
+        cmap.assign(N, -1);
+        int cnvtxs = 0;
+        for (int u = 0; u < N; ++u)
+        {
+            if (match[u] >= 0) continue;
+            int best = u;
+            Long best_w = -1;
+            for (int k = g.xadj[u]; k < g.xadj[u+1]; ++k)
+            {
+                const int v = g.adjncy[k];
+                if (match[v] < 0 && g.adjwgt[k] > best_w && g.vwgt[u]+g.vwgt[v] <= maxvwgt) {
+                    best = v;
+                    best_w = g.adjwgt[k];
+                }
+            }
+            match[u] = best;
+            match[best] = u;
+            cmap[u] = cnvtxs;
+            cmap[best] = cnvtxs;
+            ++cnvtxs;
+        }
+
+        if (cnvtxs > static_cast<int>(0.95*N)) return false;
+
+        cg.vwgt.assign(cnvtxs, 0);
+        cg.xadj.assign(cnvtxs+1, 0);
+        cg.adjncy.clear();
+        cg.adjwgt.clear();
+
+        // Position of a coarse neighbor in the current adjacency list
+        std::vector<int> pos(cnvtxs, -1);
+        int cv = 0;
+        for (int u = 0; u < N; ++u)
+        {
+            if (cmap[u] != cv) continue; // u is the second vertex of its pair
+            const int begin = cg.adjncy.size();
+            for (int v : {u, match[u]})
+            {
+                cg.vwgt[cv] += g.vwgt[v];
+                for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k)
+                {
+                    const int cw = cmap[g.adjncy[k]];
+                    if (cw == cv) continue;
+                    if (pos[cw] < 0) {
+                        pos[cw] = cg.adjncy.size();
+                        cg.adjncy.push_back(cw);
+                        cg.adjwgt.push_back(g.adjwgt[k]);
+                    } else {
+                        cg.adjwgt[pos[cw]] += g.adjwgt[k];
+                    }
+                }
+                if (match[u] == u) break;
+            }
+            for (int k = begin, M = cg.adjncy.size(); k < M; ++k) {
+                pos[cg.adjncy[k]] = -1;
+            }
+            cg.xadj[++cv] = cg.adjncy.size();
+        }
+        AMREX_ASSERT(cv == cnvtxs);
+
+        return true;
+    }
+
+    // Greedy graph growing: parts are grown one after another from a seed
+    // vertex by adding the vertex most strongly connected to the part.
+    void initialPartition (const BoxGraph& g, int nparts, std::vector<int>& part)
+    {
+        const int N = g.nvtxs();
+        part.assign(N, -1);
+
+        Long remaining = 0;
+        for (Long w : g.vwgt) remaining += w;
+
+        std::vector<Long> conn(N, 0);
+        std::vector<int> touched;
+        int next_seed = 0;
+
+        for (int p = 0; p < nparts; ++p)
+        {
+            if (p == nparts-1) {
+                for (auto& x : part) {
+                    if (x < 0) x = p;
+                }
+                break;
+            }
+
+            const Real target = static_cast<Real>(remaining) / static_cast<Real>(nparts-p);
+            Long pw = 0;
+            std::priority_queue<std::pair<Long,int> > pq;
+            for (;;)
+            {
+                int v = -1;
+                while (!pq.empty()) {
+                    auto const top = pq.top();
+                    pq.pop();
+                    if (part[top.second] < 0 && top.first == conn[top.second]) {
+                        v = top.second;
+                        break;
+                    }
+                }
+                if (v < 0) { // start a new region
+                    while (next_seed < N && part[next_seed] >= 0) ++next_seed;
+                    if (next_seed == N) break;
+                    v = next_seed;
+                }
+                // stop if adding v overshoots the target more than we undershoot it
+                if (pw > 0 && static_cast<Real>(pw+g.vwgt[v]) - target > target - static_cast<Real>(pw)) {
+                    break;
+                }
+                part[v] = p;
+                pw += g.vwgt[v];
+                for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k)
+                {
+                    const int u = g.adjncy[k];
+                    if (part[u] < 0) {
+                        if (conn[u] == 0) touched.push_back(u);
+                        conn[u] += g.adjwgt[k];
+                        pq.emplace(conn[u], u);
+                    }
+                }
+                if (static_cast<Real>(pw) >= target) break;
+            }
+
+            for (int u : touched) conn[u] = 0;
+            touched.clear();
+            remaining -= pw;
+        }
+    }
+
+    // Greedy k-way refinement of the boundary vertices.  A vertex is moved
+    // to a neighboring part if that reduces the edge cut without violating
+    // the balance constraint, or if it reduces the weight of an overloaded part.
+    void refinePartition (const BoxGraph& g, int nparts, Real max_imbalance,
+                          std::vector<int>& part)
+    {
+        const int N = g.nvtxs();
+
+        std::vector<Long> pwgts(nparts, 0);
+        Long total = 0;
+        for (int v = 0; v < N; ++v) {
+            pwgts[part[v]] += g.vwgt[v];
+            total += g.vwgt[v];
+        }
+        const Real maxpw = max_imbalance * static_cast<Real>(total) / static_cast<Real>(nparts);
+
+        std::vector<Long> ed(nparts, 0);
+        std::vector<int> nbparts;
+        constexpr int npasses = 8;
+        for (int pass = 0; pass < npasses; ++pass)
+        {
+            int nmoves = 0;
+            for (int v = 0; v < N; ++v)
+            {
+                const int from = part[v];
+                const Long vw = g.vwgt[v];
+                const bool overloaded = static_cast<Real>(pwgts[from]) > maxpw;
+
+                Long id = 0;
+                for (int k = g.xadj[v]; k < g.xadj[v+1]; ++k)
+                {
+                    const int q = part[g.adjncy[k]];
+                    if (q == from) {
+                        id += g.adjwgt[k];
+                    } else {
+                        if (ed[q] == 0) nbparts.push_back(q);
+                        ed[q] += g.adjwgt[k];
+                    }
+                }
+
+                int to = -1;
+                Long best_gain = std::numeric_limits<Long>::lowest();
+                for (int q : nbparts)
+                {
+                    const Long gain = ed[q] - id;
+                    const Long newpw = pwgts[q] + vw;
+                    bool ok;
+                    if (overloaded) {
+                        ok = newpw < pwgts[from];
+                    } else {
+                        ok = static_cast<Real>(newpw) <= maxpw &&
+                            (gain > 0 || (gain == 0 && newpw < pwgts[from]));
+                    }
+                    if (ok && (gain > best_gain ||
+                               (to >= 0 && gain == best_gain && pwgts[q] < pwgts[to]))) {
+                        to = q;
+                        best_gain = gain;
+                    }
+                }
+
+                if (to < 0 && overloaded) {
+                    // No neighboring part can take it.  Move it to the lightest part.
+                    const int q = static_cast<int>(std::min_element(pwgts.begin(), pwgts.end())
+                                                   - pwgts.begin());
+                    if (q != from && pwgts[q] + vw < pwgts[from]) {
+                        to = q;
+                    }
+                }
+
+                for (int q : nbparts) ed[q] = 0;
+                nbparts.clear();
+
+                if (to >= 0) {
+                    part[v] = to;
+                    pwgts[from] -= vw;
+                    pwgts[to] += vw;
+                    ++nmoves;
+                }
+            }
+            if (nmoves == 0) break;
+        }
+    }
+
+    // Multilevel k-way partitioning: coarsen the graph by heavy edge
+    // matching, partition the coarsest graph, and project the partition
+    // back while refining it on every level.
+    void partitionGraph (const BoxGraph& graph, int nparts, Real max_imbalance,
+                         std::vector<int>& part)
+    {
+        BL_PROFILE("partitionGraph()");
+
+        Long total = 0;
+        for (Long w : graph.vwgt) total += w;
+
+        const int coarsen_to = std::max(8*nparts, 64);
+        const Long maxvwgt = static_cast<Long>(1.5 * static_cast<double>(total) / coarsen_to) + 1;
+
+        std::vector<BoxGraph> graphs;
+        std::vector<std::vector<int> > cmaps;
+        const BoxGraph* g = &graph;
+        while (g->nvtxs() > coarsen_to)
+        {
+            BoxGraph cg;
+            std::vector<int> cmap;
+            if (!coarsenGraph(*g, maxvwgt, cg, cmap)) break;
+            graphs.push_back(std::move(cg));
+            cmaps.push_back(std::move(cmap));
+            g = &graphs.back();
+        }
+
+        if (flag_verbose_mapper) {
+            Print() << "  Graph coarsened from " << graph.nvtxs() << " to "
+                    << g->nvtxs() << " vertices in " << graphs.size() << " levels\n";
+        }
+
+        initialPartition(*g, nparts, part);
+        refinePartition(*g, nparts, max_imbalance, part);
+
+        for (int lev = static_cast<int>(graphs.size())-1; lev >= 0; --lev)
+        {
+            const BoxGraph& fg = (lev == 0) ? graph : graphs[lev-1];
+            const auto& cmap = cmaps[lev];
+            std::vector<int> fpart(fg.nvtxs());
+            for (int v = 0, N = fg.nvtxs(); v < N; ++v) {
+                fpart[v] = part[cmap[v]];
+            }
+            part = std::move(fpart);
+            refinePartition(fg, nparts, max_imbalance, part);
+        }
+    }
+}
+
+void
+DistributionMapping::GraphDoIt (const BoxArray&          boxes,
+                                const std::vector<Long>& wgts,
+                                int                   /* nprocs */,
+                                bool                     sort,
+                                Real*                    eff,
+                                Long*                    edge_cut)
+{
+    if (flag_verbose_mapper) {
+        Print() << "DM: GraphDoIt called..." << std::endl;
+    }
+
+    BL_PROFILE("DistributionMapping::GraphDoIt()");
+
+#if defined (BL_USE_TEAM)
+    amrex::Abort("Team support is not implemented yet in GRAPH");
+#endif
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    const IntVect ngrow(graph_ngrow);
+    BoxGraph graph = makeBoxGraph(boxes, wgts, ngrow);
+
+    std::vector<int> part;
+    partitionGraph(graph, nprocs, graph_max_imbalance, part);
+
+    std::vector<LIpair> LIpairV(nprocs);
+    for (int i = 0; i < nprocs; ++i) {
+        LIpairV[i] = LIpair(0,i);
+    }
+    for (int i = 0, N = boxes.size(); i < N; ++i) {
+        LIpairV[part[i]].first += wgts[i];
+    }
+
+    Long cut = 0;
+    for (int i = 0, N = graph.nvtxs(); i < N; ++i) {
+        for (int k = graph.xadj[i]; k < graph.xadj[i+1]; ++k) {
+            if (part[graph.adjncy[k]] != part[i]) cut += graph.adjwgt[k];
+        }
+    }
+    cut /= 2; // each edge has been counted twice
+
+    if (sort) Sort(LIpairV, true);
+
+    Vector<int> ord;
+    if (sort) {
+        LeastUsedCPUs(nprocs,ord);
+    } else {
+        ord.resize(nprocs);
+        std::iota(ord.begin(), ord.end(), 0);
+    }
+
+    // The heaviest part goes to the least used process.
+    Vector<int> part2rank(nprocs);
+    for (int i = 0; i < nprocs; ++i) {
+        part2rank[LIpairV[i].second] = ParallelContext::local_to_global_rank(ord[i]);
+        if (flag_verbose_mapper) {
+            Print() << "  Mapping part " << LIpairV[i].second << " of weight "
+                    << LIpairV[i].first << " to rank " << ord[i] << std::endl;
+        }
+    }
+
+    for (int i = 0, N = boxes.size(); i < N; ++i) {
+        m_ref->m_pmap[i] = part2rank[part[i]];
+    }
+
+    if (edge_cut) *edge_cut = cut;
+
+    if (eff || verbose)
+    {
+        Real sum_wgt = 0, max_wgt = 0;
+        for (auto const& p : LIpairV)
+        {
+            const Long W = p.first;
+            if (W > max_wgt) max_wgt = W;
+            sum_wgt += W;
+        }
+        Real efficiency = (sum_wgt/(nprocs*max_wgt));
+        if (eff) *eff = efficiency;
+
+        if (verbose)
+        {
+            Long total_comm = 0;
+            for (Long w : graph.adjwgt) total_comm += w;
+            total_comm /= 2;
+            amrex::Print() << "GRAPH efficiency: " << efficiency
+                           << ", edge cut: " << cut << " of " << total_comm
+                           << " ghost cells\n";
+        }
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray& boxes,
+                                        int             nprocs)
+{
+    BL_ASSERT(boxes.size() > 0);
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(boxes.size());
+
+    if (boxes.size() <= nprocs || nprocs < 2)
+    {
+        RoundRobinProcessorMap(boxes,nprocs);
+    }
+    else
+    {
+        std::vector<Long> wgts;
+
+        wgts.reserve(boxes.size());
+
+        for (int i = 0, N = boxes.size(); i < N; ++i)
+        {
+            wgts.push_back(boxes[i].numPts());
+        }
+
+        GraphDoIt(boxes,wgts,nprocs);
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray&          boxes,
+                                        const std::vector<Long>& wgts,
+                                        int                      nprocs,
+                                        Real*                    eff,
+                                        Long*                    edge_cut,
+                                        bool                     sort)
+{
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (boxes.size() <= nprocs || nprocs < 2)
+    {
+        RoundRobinProcessorMap(wgts.size(),nprocs,sort);
+
+        if (eff) *eff = 1;
+        if (edge_cut) {
+            *edge_cut = ComputeEdgeCut(*this, boxes, IntVect(graph_ngrow));
+        }
+    }
+    else
+    {
+        GraphDoIt(boxes,wgts,nprocs,sort,eff,edge_cut);
+    }
+}
+
+Long
+DistributionMapping::ComputeEdgeCut (const DistributionMapping& dm, const BoxArray& ba,
+                                     const IntVect& ngrow)
+{
+    BL_PROFILE("DistributionMapping::ComputeEdgeCut()");
+
+    Long cut = 0;
+    std::vector< std::pair<int,Box> > isects;
+    for (int i = 0, N = ba.size(); i < N; ++i)
+    {
+        ba.intersections(amrex::grow(ba[i],ngrow), isects);
+        for (auto const& is : isects)
+        {
+            if (dm[is.first] != dm[i]) cut += is.second.numPts();
+        }
+    }
+    return cut;
+}
+
 DistributionMapping
 DistributionMapping::makeKnapSack (const Vector<Real>& rcost, int nmax)
 {
@@ -1819,6 +2527,74 @@ DistributionMapping::makeSFC (const Vector<Real>& rcost, const BoxArray& ba, Rea
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeGraph (const MultiFab& weight, bool sort)
+{
+    BL_PROFILE("makeGraph");
+    Vector<Long> cost = gather_weights(weight);
+    int nprocs = ParallelContext::NProcsSub();
+    DistributionMapping r;
+    r.GraphProcessorMap(weight.boxArray(), cost, nprocs, nullptr, nullptr, sort);
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeGraph (const MultiFab& weight, Real& eff, bool sort)
+{
+    BL_PROFILE("makeGraph");
+    Vector<Long> cost = gather_weights(weight);
+    int nprocs = ParallelContext::NProcsSub();
+    DistributionMapping r;
+    r.GraphProcessorMap(weight.boxArray(), cost, nprocs, &eff, nullptr, sort);
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeGraph (const Vector<Real>& rcost, const BoxArray& ba, bool sort)
+{
+    BL_PROFILE("makeGraph");
+
+    DistributionMapping r;
+
+    Vector<Long> cost(rcost.size());
+
+    Real wmax = *std::max_element(rcost.begin(), rcost.end());
+    Real scale = (wmax == 0) ? 1.e9_rt : 1.e9_rt/wmax;
+
+    for (int i = 0; i < rcost.size(); ++i) {
+        cost[i] = Long(rcost[i]*scale) + 1L;
+    }
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    r.GraphProcessorMap(ba, cost, nprocs, nullptr, nullptr, sort);
+
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeGraph (const Vector<Real>& rcost, const BoxArray& ba, Real& eff, bool sort)
+{
+    BL_PROFILE("makeGraph");
+
+    DistributionMapping r;
+
+    Vector<Long> cost(rcost.size());
+
+    Real wmax = *std::max_element(rcost.begin(), rcost.end());
+    Real scale = (wmax == 0) ? 1.e9_rt : 1.e9_rt/wmax;
+
+    for (int i = 0; i < rcost.size(); ++i) {
+        cost[i] = Long(rcost[i]*scale) + 1L;
+    }
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    r.GraphProcessorMap(ba, cost, nprocs, &eff, nullptr, sort);
+
+    return r;
+}
+
 DistributionMapping
 DistributionMapping::makeSFC (const LayoutData<Real>& rcost_local,
                               Real& currentEfficiency, Real& proposedEfficiency,
@@ -1919,6 +2695,58 @@ DistributionMapping::makeSFC (const BoxArray& ba, bool use_box_vol, const int np
     return r;
 }
 
+std::vector<std::vector<int> >
+DistributionMapping::makeGraph (const BoxArray& ba, bool use_box_vol, const int nprocs)
+{
+    BL_PROFILE("makeGraph");
+
+    const int N = ba.size();
+    std::vector<Long> wgts;
+    wgts.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        wgts.push_back(use_box_vol ? ba[i].numPts() : Long(1));
+    }
+
+    BoxGraph graph = makeBoxGraph(ba, wgts, IntVect(graph_ngrow));
+
+    std::vector<int> part;
+    partitionGraph(graph, nprocs, graph_max_imbalance, part);
+
+    std::vector< std::vector<int> > r(nprocs);
+    for (int i = 0; i < N; ++i) {
+        r[part[i]].push_back(i);
+    }
+
+    return r;
+}
+
+std::vector<std::vector<int> >
+DistributionMapping::makeSFC (const BoxArray& ba, const Vector<Vector<int> >& node_ranks,
+                              bool use_box_vol)
+{
+    BL_PROFILE("makeSFC");
+
+    const int N = ba.size();
+    std::vector<SFCToken> tokens;
+    std::vector<Long> wgts;
+    tokens.reserve(N);
+    wgts.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        const Box& bx = ba[i];
+        tokens.push_back(makeSFCToken(i, bx.smallEnd()));
+        wgts.push_back(use_box_vol ? bx.numPts() : Long(1));
+    }
+    std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+
+    std::vector<std::vector<int> > nr(node_ranks.begin(), node_ranks.end());
+    std::vector< std::vector<int> > r;
+    DistributeNodeAware(tokens, wgts, nr, r);
+
+    return r;
+}
+
 const Vector<int>&
 DistributionMapping::getIndexArray ()
 {
@@ -31,6 +31,7 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 int     FabArrayBase::MaxComp;
+bool    FabArrayBase::fb_persistent_comm = false;
 
 #if defined(AMREX_USE_GPU)
 
@@ -69,6 +70,10 @@ FabArrayBase::PolarBCache          FabArrayBase::m_ThePolarBCache;
 FabArrayBase::FPinfoCache          FabArrayBase::m_TheFillPatchCache;
 FabArrayBase::CFinfoCache          FabArrayBase::m_TheCrseFineCache;
 
+std::list<FabArrayBase::CommCacheItem*> FabArrayBase::m_comm_cache_lru;
+Long                               FabArrayBase::m_comm_cache_bytes = 0;
+Long                               FabArrayBase::m_comm_cache_max_bytes = 0;
+
 #ifdef AMREX_USE_GPU
 std::multimap<FabArrayBase::BDKey,FabArrayBase::ParForInfo*> FabArrayBase::m_TheParForCache;
 #endif
@@ -102,6 +107,7 @@ FabArrayBase::Initialize ()
     // Set default values here!!!
     //
     FabArrayBase::MaxComp           = 25;
+    FabArrayBase::fb_persistent_comm = false;
 
     ParmParse pp("fabarray");
 
@@ -118,11 +124,17 @@ FabArrayBase::Initialize ()
     }
 
     pp.queryAdd("maxcomp",             FabArrayBase::MaxComp);
+    pp.queryAdd("fb_persistent_comm",  FabArrayBase::fb_persistent_comm);
 
     if (MaxComp < 1) {
         MaxComp = 1;
     }
 
+    {
+        ParmParse pp_amrex("amrex");
+        pp_amrex.queryAdd("comm_cache_max_bytes", m_comm_cache_max_bytes);
+    }
+
 #ifdef AMREX_USE_GPU
     if (ParallelDescriptor::UseGpuAwareMpi()) {
         the_fa_arena = The_Arena();
@@ -544,9 +556,6 @@ FabArrayBase::flushCPC (bool no_assertion) const
             }
         }
 
-#ifdef AMREX_MEM_PROFILING
-        m_CPC_stats.bytes -= it->second->bytes();
-#endif
         m_CPC_stats.recordErase(it->second->m_nuse);
         delete it->second;
     }
@@ -575,9 +584,6 @@ FabArrayBase::flushCPCache ()
         delete c;
     }
     m_TheCPCache.clear();
-#ifdef AMREX_MEM_PROFILING
-    m_CPC_stats.bytes = 0L;
-#endif
 }
 
 const FabArrayBase::CPC&
@@ -608,6 +614,7 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
         {
             ++(it->second->m_nuse);
             m_CPC_stats.recordUse();
+            touchCommCacheItem(it->second);
             return *(it->second);
         }
     }
@@ -615,11 +622,6 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
     // Have to build a new one
     CPC* new_cpc = new CPC(*this, dstng, src, srcng, period, to_ghost_cells_only);
 
-#ifdef AMREX_MEM_PROFILING
-    m_CPC_stats.bytes += new_cpc->bytes();
-    m_CPC_stats.bytes_hwm = std::max(m_CPC_stats.bytes_hwm, m_CPC_stats.bytes);
-#endif
-
     new_cpc->m_nuse = 1;
     m_CPC_stats.recordBuild();
     m_CPC_stats.recordUse();
@@ -629,6 +631,8 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
         m_TheCPCache.insert(          CPCache::value_type(srckey,new_cpc));
     }
 
+    addCommCacheItem(new_cpc, CommCacheItem::CPCacheType, dstkey, new_cpc->bytes());
+
     return *new_cpc;
 }
 
@@ -1172,6 +1176,16 @@ FabArrayBase::FB::define_os (const FabArrayBase& fa)
 FabArrayBase::FB::~FB ()
 {}
 
+#ifdef BL_USE_MPI
+FabArrayBase::FB::PersistentComm::~PersistentComm ()
+{
+    ParallelDescriptor::Request_free(recv_reqs);
+    ParallelDescriptor::Request_free(send_reqs);
+    if (the_recv_data) { The_FA_Arena()->free(the_recv_data); }
+    if (the_send_data) { The_FA_Arena()->free(the_send_data); }
+}
+#endif
+
 void
 FabArrayBase::flushFB (bool no_assertion) const
 {
@@ -1180,9 +1194,6 @@ FabArrayBase::flushFB (bool no_assertion) const
     std::pair<FBCacheIter,FBCacheIter> er_it = m_TheFBCache.equal_range(m_bdkey);
     for (FBCacheIter it = er_it.first; it != er_it.second; ++it)
     {
-#ifdef AMREX_MEM_PROFILING
-        m_FBC_stats.bytes -= it->second->bytes();
-#endif
         m_FBC_stats.recordErase(it->second->m_nuse);
         delete it->second;
     }
@@ -1198,9 +1209,6 @@ FabArrayBase::flushFBCache ()
         delete it->second;
     }
     m_TheFBCache.clear();
-#ifdef AMREX_MEM_PROFILING
-    m_FBC_stats.bytes = 0L;
-#endif
 }
 
 const FabArrayBase::FB&
@@ -1225,6 +1233,7 @@ FabArrayBase::getFB (const IntVect& nghost, const Periodicity& period,
         {
             ++(it->second->m_nuse);
             m_FBC_stats.recordUse();
+            touchCommCacheItem(it->second);
             return *(it->second);
         }
     }
@@ -1233,17 +1242,14 @@ FabArrayBase::getFB (const IntVect& nghost, const Periodicity& period,
     FB* new_fb = new FB(*this, nghost, cross, period, enforce_periodicity_only,
                         override_sync, m_multi_ghost);
 
-#ifdef AMREX_MEM_PROFILING
-    m_FBC_stats.bytes += new_fb->bytes();
-    m_FBC_stats.bytes_hwm = std::max(m_FBC_stats.bytes_hwm, m_FBC_stats.bytes);
-#endif
-
     new_fb->m_nuse = 1;
     m_FBC_stats.recordBuild();
     m_FBC_stats.recordUse();
 
     m_TheFBCache.insert(er_it.second, FBCache::value_type(m_bdkey,new_fb));
 
+    addCommCacheItem(new_fb, CommCacheItem::FBCacheType, m_bdkey, new_fb->bytes());
+
     return *new_fb;
 }
 
@@ -2000,6 +2006,7 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
         {
             ++(it->second->m_nuse);
             m_FPinfo_stats.recordUse();
+            touchCommCacheItem(it->second);
             return *(it->second);
         }
     }
@@ -2008,11 +2015,6 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
     FPinfo* new_fpc = new FPinfo(srcfa, dstfa, dstdomain, dstng, coarsener,
                                  fgeom.Domain(), cgeom.Domain(), index_space);
 
-#ifdef AMREX_MEM_PROFILING
-    m_FPinfo_stats.bytes += new_fpc->bytes();
-    m_FPinfo_stats.bytes_hwm = std::max(m_FPinfo_stats.bytes_hwm, m_FPinfo_stats.bytes);
-#endif
-
     new_fpc->m_nuse = 1;
     m_FPinfo_stats.recordBuild();
     m_FPinfo_stats.recordUse();
@@ -2021,6 +2023,8 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
     if (srckey != dstkey)
         m_TheFillPatchCache.insert(          FPinfoCache::value_type(srckey,new_fpc));
 
+    addCommCacheItem(new_fpc, CommCacheItem::FPinfoCacheType, dstkey, new_fpc->bytes());
+
     return *new_fpc;
 }
 
@@ -2053,9 +2057,6 @@ FabArrayBase::flushFPinfo (bool no_assertion)
             }
         }
 
-#ifdef AMREX_MEM_PROFILING
-        m_FPinfo_stats.bytes -= it->second->bytes();
-#endif
         m_FPinfo_stats.recordErase(it->second->m_nuse);
         delete it->second;
     }
@@ -2163,6 +2164,7 @@ FabArrayBase::TheCFinfo (const FabArrayBase& finefa,
         {
             ++(it->second->m_nuse);
             m_CFinfo_stats.recordUse();
+            touchCommCacheItem(it->second);
             return *(it->second);
         }
     }
@@ -2170,17 +2172,14 @@ FabArrayBase::TheCFinfo (const FabArrayBase& finefa,
     // Have to build a new one
     CFinfo* new_cfinfo = new CFinfo(finefa, finegm, ng, include_periodic, include_physbndry);
 
-#ifdef AMREX_MEM_PROFILING
-    m_CFinfo_stats.bytes += new_cfinfo->bytes();
-    m_CFinfo_stats.bytes_hwm = std::max(m_CFinfo_stats.bytes_hwm, m_CFinfo_stats.bytes);
-#endif
-
     new_cfinfo->m_nuse = 1;
     m_CFinfo_stats.recordBuild();
     m_CFinfo_stats.recordUse();
 
     m_TheCrseFineCache.insert(er_it.second, CFinfoCache::value_type(key,new_cfinfo));
 
+    addCommCacheItem(new_cfinfo, CommCacheItem::CFinfoCacheType, key, new_cfinfo->bytes());
+
     return *new_cfinfo;
 }
 
@@ -2192,15 +2191,135 @@ FabArrayBase::flushCFinfo (bool no_assertion)
     auto er_it = m_TheCrseFineCache.equal_range(m_bdkey);
     for (auto it = er_it.first; it != er_it.second; ++it)
     {
-#ifdef AMREX_MEM_PROFILING
-        m_CFinfo_stats.bytes -= it->second->bytes();
-#endif
         m_CFinfo_stats.recordErase(it->second->m_nuse);
         delete it->second;
     }
     m_TheCrseFineCache.erase(er_it.first, er_it.second);
 }
 
+FabArrayBase::CommCacheItem::~CommCacheItem ()
+{
+    if (m_in_lru) {
+        m_comm_cache_lru.erase(m_lru_it);
+        m_comm_cache_bytes -= m_cache_bytes;
+        commCacheStats(m_cache_type).bytes -= m_cache_bytes;
+    }
+}
+
+FabArrayBase::CacheStats&
+FabArrayBase::commCacheStats (CommCacheItem::CacheType type)
+{
+    switch (type) {
+    case CommCacheItem::FBCacheType:     return m_FBC_stats;
+    case CommCacheItem::CPCacheType:     return m_CPC_stats;
+    case CommCacheItem::FPinfoCacheType: return m_FPinfo_stats;
+    default:                             return m_CFinfo_stats;
+    }
+}
+
+void
+FabArrayBase::addCommCacheItem (CommCacheItem* item, CommCacheItem::CacheType type,
+                                const BDKey& key, Long nbytes)
+{
+    item->m_cache_type = type;
+    item->m_cache_key = key;
+    item->m_cache_bytes = nbytes;
+    m_comm_cache_lru.push_front(item);
+    item->m_lru_it = m_comm_cache_lru.begin();
+    item->m_in_lru = true;
+    m_comm_cache_bytes += nbytes;
+    commCacheStats(type).recordBytes(nbytes);
+
+    // The new item is about to be returned to the caller.
+    CommCachePin pin(*item);
+    trimCommCaches();
+}
+
+void
+FabArrayBase::touchCommCacheItem (CommCacheItem* item)
+{
+    if (item->m_in_lru && item->m_lru_it != m_comm_cache_lru.begin()) {
+        m_comm_cache_lru.splice(m_comm_cache_lru.begin(), m_comm_cache_lru, item->m_lru_it);
+    }
+}
+
+void
+FabArrayBase::trimCommCaches ()
+{
+    if (m_comm_cache_max_bytes <= 0) { return; }
+
+    // Items referenced by the callers are pinned and kept.
+    auto it = m_comm_cache_lru.end();
+    while (m_comm_cache_bytes > m_comm_cache_max_bytes && it != m_comm_cache_lru.begin())
+    {
+        CommCacheItem* item = *(--it);
+        if (item->m_npin == 0) {
+            ++it; // so that it is still valid after the item is erased from the list
+            evictCommCacheItem(item);
+        }
+    }
+}
+
+namespace {
+    template <class Cache, class K, class T>
+    void eraseCacheEntry (Cache& cache, const K& key, T* item)
+    {
+        auto er_it = cache.equal_range(key);
+        for (auto it = er_it.first; it != er_it.second; ++it) {
+            if (it->second == item) {
+                cache.erase(it);
+                return;
+            }
+        }
+    }
+}
+
+void
+FabArrayBase::evictCommCacheItem (CommCacheItem* item)
+{
+    commCacheStats(item->m_cache_type).recordEvict(item->m_cache_bytes);
+
+    switch (item->m_cache_type) {
+    case CommCacheItem::FBCacheType:
+    {
+        auto* p = static_cast<FB*>(item);
+        eraseCacheEntry(m_TheFBCache, item->m_cache_key, p);
+        m_FBC_stats.recordErase(p->m_nuse);
+        delete p;
+        break;
+    }
+    case CommCacheItem::CPCacheType:
+    {
+        auto* p = static_cast<CPC*>(item);
+        eraseCacheEntry(m_TheCPCache, p->m_dstbdk, p);
+        if (p->m_srcbdk != p->m_dstbdk) {
+            eraseCacheEntry(m_TheCPCache, p->m_srcbdk, p);
+        }
+        m_CPC_stats.recordErase(p->m_nuse);
+        delete p;
+        break;
+    }
+    case CommCacheItem::FPinfoCacheType:
+    {
+        auto* p = static_cast<FPinfo*>(item);
+        eraseCacheEntry(m_TheFillPatchCache, p->m_dstbdk, p);
+        if (p->m_srcbdk != p->m_dstbdk) {
+            eraseCacheEntry(m_TheFillPatchCache, p->m_srcbdk, p);
+        }
+        m_FPinfo_stats.recordErase(p->m_nuse);
+        delete p;
+        break;
+    }
+    default:
+    {
+        auto* p = static_cast<CFinfo*>(item);
+        eraseCacheEntry(m_TheCrseFineCache, item->m_cache_key, p);
+        m_CFinfo_stats.recordErase(p->m_nuse);
+        delete p;
+    }
+    }
+}
+
 void
 FabArrayBase::Finalize ()
 {
@@ -2215,6 +2334,13 @@ FabArrayBase::Finalize ()
     FabArrayBase::flushParForCache();
 #endif
 
+    // The FillPatch and CrseFine caches are flushed by their FabArrays.
+    for (auto* item : m_comm_cache_lru) {
+        item->m_in_lru = false;
+    }
+    m_comm_cache_lru.clear();
+    m_comm_cache_bytes = 0;
+
     if (ParallelDescriptor::IOProcessor() && amrex::system::verbose > 1) {
         m_FA_stats.print();
         m_TAC_stats.print();
@@ -0,0 +1,224 @@
+#include <AMReX_FabCompression.H>
+#include <AMReX.H>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace amrex::FabCompression {
+
+namespace {
+
+// A run of 3 to 130 equal bytes is stored as (128 + length - 3, byte).
+// Up to 128 other bytes are stored as (count - 1, bytes...).
+constexpr Long min_run = 3;
+constexpr Long max_run = 130;
+constexpr Long max_literal = 128;
+
+// Append the run-length encoded n bytes at p to out.
+void rle_encode (unsigned char const* p, Long n, Vector<char>& out)
+{
+    const Long old_size = out.size();
+    out.resize(old_size + n + n/max_literal + 1);
+    auto* q = reinterpret_cast<unsigned char*>(out.data()) + old_size;
+
+    Long i = 0;
+    while (i < n) {
+        Long r = 1;
+        while (i+r < n && r < max_run && p[i+r] == p[i]) { ++r; }
+        if (r >= min_run) {
+            *q++ = static_cast<unsigned char>(128 + r - min_run);
+            *q++ = p[i];
+            i += r;
+        } else {
+            Long j = i;
+            while (j < n && j-i < max_literal &&
+                   ! (j+2 < n && p[j] == p[j+1] && p[j] == p[j+2])) {
+                ++j;
+            }
+            *q++ = static_cast<unsigned char>(j-i-1);
+            std::memcpy(q, p+i, j-i);
+            q += j-i;
+            i = j;
+        }
+    }
+
+    out.resize(q - reinterpret_cast<unsigned char*>(out.data()));
+}
+
+// Decode n bytes into p.  Returns the position after the encoded bytes.
+unsigned char const* rle_decode (unsigned char const* src, unsigned char const* end,
+                                 unsigned char* p, Long n)
+{
+    Long i = 0;
+    while (i < n) {
+        AMREX_ALWAYS_ASSERT(src < end);
+        const Long c = *src++;
+        if (c >= 128) {
+            const Long r = c - 128 + min_run;
+            AMREX_ALWAYS_ASSERT(i+r <= n && src < end);
+            std::memset(p+i, *src++, r);
+            i += r;
+        } else {
+            const Long r = c + 1;
+            AMREX_ALWAYS_ASSERT(i+r <= n && src+r <= end);
+            std::memcpy(p+i, src, r);
+            src += r;
+            i += r;
+        }
+    }
+    return src;
+}
+
+// Shuffle the words into byte planes and encode each plane.
+template <typename U>
+void encode_words (Vector<U> const& w, Vector<char>& out)
+{
+    const Long n = w.size();
+    Vector<unsigned char> plane(n);
+    for (int k = 0; k < static_cast<int>(sizeof(U)); ++k) {
+        for (Long i = 0; i < n; ++i) {
+            plane[i] = static_cast<unsigned char>(w[i] >> (8*k));
+        }
+        rle_encode(plane.data(), n, out);
+    }
+}
+
+template <typename U>
+void decode_words (unsigned char const* src, unsigned char const* end, Vector<U>& w)
+{
+    const Long n = w.size();
+    Vector<unsigned char> plane(n);
+    for (Long i = 0; i < n; ++i) { w[i] = 0; }
+    for (int k = 0; k < static_cast<int>(sizeof(U)); ++k) {
+        src = rle_decode(src, end, plane.data(), n);
+        for (Long i = 0; i < n; ++i) {
+            w[i] |= static_cast<U>(plane[i]) << (8*k);
+        }
+    }
+}
+
+template <typename T>
+using word_t = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+
+// Quantized values are kept below 2^50 so that the reconstruction error
+// stays within the tolerance.
+constexpr double max_quantized = 1125899906842624.0;
+
+template <typename T>
+bool quantize (T const* src, Long n, double tolerance, Vector<std::uint64_t>& w)
+{
+    std::int64_t qprev = 0;
+    for (Long i = 0; i < n; ++i) {
+        const double x = static_cast<double>(src[i]) / tolerance;
+        if (! (std::abs(x) < max_quantized)) { return false; }
+        const auto q = static_cast<std::int64_t>(std::llround(x));
+        // Zigzag encode the difference so that small negative steps stay small.
+        const auto d = static_cast<std::uint64_t>(q) - static_cast<std::uint64_t>(qprev);
+        w[i] = (d << 1) ^ (0 - (d >> 63));
+        qprev = q;
+    }
+    return true;
+}
+
+}
+
+Method method (char const* src)
+{
+    return static_cast<Method>(static_cast<unsigned char>(src[0]));
+}
+
+template <typename T>
+void compress (T const* src, Long n, double tolerance, Vector<char>& out)
+{
+    static_assert(std::is_floating_point<T>::value, "FabCompression: T must be floating point");
+    using U = word_t<T>;
+
+    const Long begin = out.size();
+    bool done = false;
+
+    if (tolerance > 0.0) {
+        Vector<std::uint64_t> w(n);
+        if (quantize(src, n, tolerance, w)) {
+            out.push_back(static_cast<char>(Quantized));
+            const Long pos = out.size();
+            out.resize(pos + sizeof(double));
+            std::memcpy(out.data() + pos, &tolerance, sizeof(double));
+            encode_words(w, out);
+            done = true;
+        }
+    }
+
+    if (! done) {
+        Vector<U> w(n);
+        U prev = 0;
+        for (Long i = 0; i < n; ++i) {
+            U u;
+            std::memcpy(&u, src+i, sizeof(U));
+            w[i] = u ^ prev;
+            prev = u;
+        }
+        out.push_back(static_cast<char>(Lossless));
+        encode_words(w, out);
+    }
+
+    if (static_cast<Long>(out.size()) - begin > 1 + n*Long(sizeof(T))) {
+        out.resize(begin + 1 + n*sizeof(T));
+        out[begin] = static_cast<char>(Raw);
+        std::memcpy(out.data() + begin + 1, src, n*sizeof(T));
+    }
+}
+
+template <typename T>
+void decompress (char const* src, Long nbytes, T* dst, Long n)
+{
+    using U = word_t<T>;
+
+    AMREX_ALWAYS_ASSERT(nbytes >= 1);
+    const auto* p   = reinterpret_cast<unsigned char const*>(src) + 1;
+    const auto* end = reinterpret_cast<unsigned char const*>(src) + nbytes;
+
+    switch (method(src)) {
+    case Raw:
+    {
+        AMREX_ALWAYS_ASSERT(nbytes == 1 + n*Long(sizeof(T)));
+        std::memcpy(dst, p, n*sizeof(T));
+        break;
+    }
+    case Lossless:
+    {
+        Vector<U> w(n);
+        decode_words(p, end, w);
+        U prev = 0;
+        for (Long i = 0; i < n; ++i) {
+            prev ^= w[i];
+            std::memcpy(dst+i, &prev, sizeof(U));
+        }
+        break;
+    }
+    case Quantized:
+    {
+        AMREX_ALWAYS_ASSERT(nbytes >= 1 + Long(sizeof(double)));
+        double tolerance;
+        std::memcpy(&tolerance, p, sizeof(double));
+        Vector<std::uint64_t> w(n);
+        decode_words(p + sizeof(double), end, w);
+        std::uint64_t q = 0;
+        for (Long i = 0; i < n; ++i) {
+            q += (w[i] >> 1) ^ (0 - (w[i] & 1));
+            dst[i] = static_cast<T>(static_cast<double>(static_cast<std::int64_t>(q)) * tolerance);
+        }
+        break;
+    }
+    default:
+        amrex::Abort("FabCompression::decompress: unknown method");
+    }
+}
+
+template void compress<float>  (float  const*, Long, double, Vector<char>&);
+template void compress<double> (double const*, Long, double, Vector<char>&);
+template void decompress<float>  (char const*, Long, float*,  Long);
+template void decompress<double> (char const*, Long, double*, Long);
+
+}
@@ -2,9 +2,12 @@
 
 #ifndef AMREX_USE_MPI
 
+#include <AMReX_Vector.H>
+
 namespace amrex {
 namespace machine {
     void Initialize () {}
+    Vector<int> get_node_ids () { return Vector<int>(1,0); }
 }}
 
 #else
@@ -217,6 +220,18 @@ class Machine
         get_params();
         get_machine_envs();
         node_ids = get_node_ids();
+        shm_node_ids = get_shm_node_ids();
+    }
+
+    // node IDs of the ranks in the current ParallelContext subgroup
+    Vector<int> get_subgroup_node_ids ()
+    {
+        auto sg_g_ranks = get_subgroup_ranks();
+        Vector<int> result(sg_g_ranks.size());
+        for (int i = 0; i < sg_g_ranks.size(); ++i) {
+            result[i] = shm_node_ids[sg_g_ranks[i]];
+        }
+        return result;
     }
 
     // find a compact neighborhood of size rank_n in the current ParallelContext subgroup
@@ -323,6 +338,8 @@ class Machine
     bool flag_nersc_df;
     // int my_node_id;
     Vector<int> node_ids;
+    // node IDs from shared memory communicators, indexed by job rank
+    Vector<int> shm_node_ids;
 
     NeighborhoodCache nbh_cache;
 
@@ -431,6 +448,24 @@ class Machine
         return ids;
     }
 
+    // get all node IDs in this job from ranks that can share memory, indexed
+    // by job rank.  The ID of a node is the lowest job rank on it.
+    // this is collective over ALL ranks in the job
+    Vector<int> get_shm_node_ids ()
+    {
+        MPI_Comm node_comm;
+        MPI_Comm_split_type(ParallelContext::CommunicatorAll(), MPI_COMM_TYPE_SHARED, 0,
+                            MPI_INFO_NULL, &node_comm);
+        int my_rank = ParallelDescriptor::MyProc();
+        int node_id;
+        MPI_Allreduce(&my_rank, &node_id, 1, MPI_INT, MPI_MIN, node_comm);
+        MPI_Comm_free(&node_comm);
+
+        Vector<int> ids(ParallelDescriptor::NProcs(), 0);
+        ParallelAllGather::AllGather(node_id, ids.data(), ParallelContext::CommunicatorAll());
+        return ids;
+    }
+
     // do a local search starting at current node
     std::pair<Vector<int>, double>
     baseline_score(const Vector<int> & sg_node_ids, int nbh_rank_n)
@@ -595,6 +630,11 @@ Vector<int> find_best_nbh (int rank_n, bool flag_local_ranks) {
     return the_machine->find_best_nbh(rank_n, flag_local_ranks);
 }
 
+Vector<int> get_node_ids () {
+    AMREX_ASSERT(the_machine);
+    return the_machine->get_subgroup_node_ids();
+}
+
 }}
 
 #endif
@@ -1025,6 +1025,7 @@ void
 Wait (MPI_Request& req, MPI_Status& status)
 {
     BL_PROFILE_S("ParallelDescriptor::Wait()");
+    BL_PROFILE_TINY_WAIT("ParallelDescriptor::Wait()");
     BL_COMM_PROFILE_WAIT(BLProfiler::Wait, req, status, true);
     BL_MPI_REQUIRE( MPI_Wait(&req, &status) );
     BL_COMM_PROFILE_WAIT(BLProfiler::Wait, req, status, false);
@@ -1036,6 +1037,7 @@ Waitall (Vector<MPI_Request>& reqs, Vector<MPI_Status>& status)
     BL_ASSERT(status.size() >= reqs.size());
 
     BL_PROFILE_S("ParallelDescriptor::Waitall()");
+    BL_PROFILE_TINY_WAIT("ParallelDescriptor::Waitall()");
     BL_COMM_PROFILE_WAITSOME(BLProfiler::Waitall, reqs, reqs.size(), status, true);
     BL_MPI_REQUIRE( MPI_Waitall(reqs.size(),
                                 reqs.dataPtr(),
@@ -1047,6 +1049,7 @@ void
 Waitany (Vector<MPI_Request>& reqs, int &index, MPI_Status& status)
 {
     BL_PROFILE_S("ParallelDescriptor::Waitany()");
+    BL_PROFILE_TINY_WAIT("ParallelDescriptor::Waitany()");
     BL_COMM_PROFILE_WAIT(BLProfiler::Waitany, reqs[0], status, true);
     BL_MPI_REQUIRE( MPI_Waitany(reqs.size(),
                                 reqs.dataPtr(),
@@ -1063,6 +1066,7 @@ Waitsome (Vector<MPI_Request>& reqs, int& completed,
     BL_ASSERT(indx.size() >= reqs.size());
 
     BL_PROFILE_S("ParallelDescriptor::Waitsome()");
+    BL_PROFILE_TINY_WAIT("ParallelDescriptor::Waitsome()");
     BL_COMM_PROFILE_WAITSOME(BLProfiler::Waitsome, reqs, reqs.size(), status, true);
     BL_MPI_REQUIRE( MPI_Waitsome(reqs.size(),
                                  reqs.dataPtr(),
@@ -1768,6 +1772,85 @@ Recv<char> (char* buf, size_t n, int pid, int tag, MPI_Comm comm)
     return msg;
 }
 
+MPI_Request
+Send_init (const char* buf, std::size_t n, int pid, int tag, MPI_Comm comm)
+{
+    MPI_Request req;
+    const int comm_data_type = ParallelDescriptor::select_comm_data_type(n);
+    if (comm_data_type == 1) {
+        BL_MPI_REQUIRE( MPI_Send_init(const_cast<char*>(buf), n,
+                                      Mpi_typemap<char>::type(),
+                                      pid, tag, comm, &req) );
+    } else if (comm_data_type == 2) {
+        AMREX_ALWAYS_ASSERT(amrex::is_aligned(buf, alignof(unsigned long long))
+                            && (n % sizeof(unsigned long long)) == 0);
+        BL_MPI_REQUIRE( MPI_Send_init(const_cast<char*>(buf), n/sizeof(unsigned long long),
+                                      Mpi_typemap<unsigned long long>::type(),
+                                      pid, tag, comm, &req) );
+    } else if (comm_data_type == 3) {
+        AMREX_ALWAYS_ASSERT(amrex::is_aligned(buf, alignof(ParallelDescriptor::lull_t))
+                            && (n % sizeof(ParallelDescriptor::lull_t)) == 0);
+        BL_MPI_REQUIRE( MPI_Send_init(const_cast<char*>(buf), n/sizeof(ParallelDescriptor::lull_t),
+                                      Mpi_typemap<ParallelDescriptor::lull_t>::type(),
+                                      pid, tag, comm, &req) );
+    } else {
+        amrex::Abort("ParallelDescriptor::Send_init: message of " + std::to_string(n)
+                     + " bytes to process " + std::to_string(pid)
+                     + " is too big for one MPI message");
+    }
+    return req;
+}
+
+MPI_Request
+Recv_init (char* buf, std::size_t n, int pid, int tag, MPI_Comm comm)
+{
+    MPI_Request req;
+    const int comm_data_type = ParallelDescriptor::select_comm_data_type(n);
+    if (comm_data_type == 1) {
+        BL_MPI_REQUIRE( MPI_Recv_init(buf, n,
+                                      Mpi_typemap<char>::type(),
+                                      pid, tag, comm, &req) );
+    } else if (comm_data_type == 2) {
+        AMREX_ALWAYS_ASSERT(amrex::is_aligned(buf, alignof(unsigned long long))
+                            && (n % sizeof(unsigned long long)) == 0);
+        BL_MPI_REQUIRE( MPI_Recv_init(buf, n/sizeof(unsigned long long),
+                                      Mpi_typemap<unsigned long long>::type(),
+                                      pid, tag, comm, &req) );
+    } else if (comm_data_type == 3) {
+        AMREX_ALWAYS_ASSERT(amrex::is_aligned(buf, alignof(ParallelDescriptor::lull_t))
+                            && (n % sizeof(ParallelDescriptor::lull_t)) == 0);
+        BL_MPI_REQUIRE( MPI_Recv_init(buf, n/sizeof(ParallelDescriptor::lull_t),
+                                      Mpi_typemap<ParallelDescriptor::lull_t>::type(),
+                                      pid, tag, comm, &req) );
+    } else {
+        amrex::Abort("ParallelDescriptor::Recv_init: message of " + std::to_string(n)
+                     + " bytes from process " + std::to_string(pid)
+                     + " is too big for one MPI message");
+    }
+    return req;
+}
+
+void
+Startall (Vector<MPI_Request>& reqs)
+{
+    BL_PROFILE_S("ParallelDescriptor::Startall()");
+    for (auto& req : reqs) {
+        if (req != MPI_REQUEST_NULL) {
+            BL_MPI_REQUIRE( MPI_Start(&req) );
+        }
+    }
+}
+
+void
+Request_free (Vector<MPI_Request>& reqs)
+{
+    for (auto& req : reqs) {
+        if (req != MPI_REQUEST_NULL) {
+            BL_MPI_REQUIRE( MPI_Request_free(&req) );
+        }
+    }
+}
+
 #endif
 
 }}
@@ -1,7 +1,17 @@
 #include <AMReX_PlotFileDataImpl.H>
+#include <AMReX_FPC.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_VisMF.H>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace amrex {
 
@@ -99,7 +109,10 @@ PlotFileDataImpl::PlotFileDataImpl (std::string const& plotfile_name)
     }
 }
 
-PlotFileDataImpl::~PlotFileDataImpl () {}
+PlotFileDataImpl::~PlotFileDataImpl ()
+{
+    unmapFiles();
+}
 
 void
 PlotFileDataImpl::syncDistributionMap (PlotFileDataImpl const& src) noexcept
@@ -130,19 +143,257 @@ MultiFab
 PlotFileDataImpl::get (int level, std::string const& varname) noexcept
 {
     MultiFab mf(m_ba[level], m_dmap[level], 1, m_ngrow[level]);
+    int icomp = varIndex(varname);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        int gid = mfi.index();
+        FArrayBox& dstfab = mf[mfi];
+        std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
+        dstfab.copy<RunOn::Host>(*srcfab);
+    }
+    return mf;
+}
+
+MultiFab
+PlotFileDataImpl::get (int level, Box const& region, Vector<std::string> const& varnames) noexcept
+{
+    BL_PROFILE("PlotFileDataImpl::get(region)");
+
+    Vector<int> comps;
+    for (auto const& name : varnames) {
+        comps.push_back(varIndex(name));
+    }
+
+    const Box bx = region & m_ba[level].minimalBox();
+    if (! bx.ok() || comps.empty()) { return MultiFab(); }
+
+    BoxList bl;
+    Vector<int> gids, pmap;
+    for (auto const& is : m_ba[level].intersections(bx)) {
+        bl.push_back(is.second);
+        gids.push_back(is.first);
+        pmap.push_back(m_dmap[level][is.first]);
+    }
+    if (bl.isEmpty()) { return MultiFab(); }
+
+    MultiFab mf(BoxArray(std::move(bl)), DistributionMapping(std::move(pmap)),
+                static_cast<int>(comps.size()), 0);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        for (int n = 0; n < comps.size(); ++n) {
+            readRegion(level, gids[mfi.index()], comps[n], mfi.validbox(), mf[mfi], n);
+        }
+    }
+    return mf;
+}
+
+MultiFab
+PlotFileDataImpl::get (int level, RealBox const& region, Vector<std::string> const& varnames) noexcept
+{
+    // ---- the cells that intersect the region
+    IntVect lo(0), hi(0);
+    for (int idim = 0; idim < m_spacedim; ++idim) {
+        const Real dx = m_cell_size[level][idim];
+        lo[idim] = static_cast<int>(std::floor((region.lo(idim)-m_prob_lo[idim])/dx));
+        hi[idim] = static_cast<int>(std::ceil ((region.hi(idim)-m_prob_lo[idim])/dx)) - 1;
+        hi[idim] = std::max(lo[idim], hi[idim]);
+    }
+    return get(level, Box(lo,hi), varnames);
+}
+
+void
+PlotFileDataImpl::setMemoryMapped (bool flag) noexcept
+{
+    m_memory_mapped = flag;
+    if (! flag) { unmapFiles(); }
+}
+
+FArrayBox
+PlotFileDataImpl::getFab (int level, int gid, std::string const& varname) noexcept
+{
+    const int icomp = varIndex(varname);
+    const Box fabbox = amrex::grow(m_ba[level][gid], m_ngrow[level]);
+
+    std::string file_name;
+    Long offset;
+    RealDescriptor rd;
+    if (m_memory_mapped && locateComponent(level, gid, icomp, file_name, offset, rd) &&
+        rd == FPC::NativeRealDescriptor() && offset % alignof(Real) == 0)
+    {
+        char const* p = mapFile(file_name);
+        if (p) {
+            return FArrayBox(fabbox, 1, reinterpret_cast<Real const*>(p + offset));
+        }
+    }
+
+    FArrayBox fab(fabbox, 1);
+    readRegion(level, gid, icomp, fabbox, fab, 0);
+    return fab;
+}
+
+int
+PlotFileDataImpl::varIndex (std::string const& varname) const
+{
     auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
     if (r == std::end(m_var_names)) {
         amrex::Abort("PlotFileDataImpl::get: varname not found "+varname);
+    }
+    return static_cast<int>(std::distance(std::begin(m_var_names), r));
+}
+
+bool
+PlotFileDataImpl::locateComponent (int level, int gid, int icomp, std::string& file_name,
+                                   Long& offset, RealDescriptor& rd)
+{
+    const VisMF::Header& hdr = m_vismf[level]->header();
+    const Long npts = amrex::grow(hdr.m_ba[gid], hdr.m_ngrow).numPts();
+    file_name = VisMF::DirName(m_mf_name[level]) + hdr.m_fod[gid].m_name;
+    offset = hdr.m_fod[gid].m_head;
+
+    if (hdr.m_vers == VisMF::Header::Compressed_v1) {
+        return false;
+    } else if (hdr.m_vers == VisMF::Header::Version_v1) {
+        // ---- skip the fab header:  FAB RealDescriptor Box ncomp
+        std::istringstream hss;
+        std::ifstream* ifs = nullptr;
+        std::istream* is;
+        char const* p = m_memory_mapped ? mapFile(file_name) : nullptr;
+        if (p) {
+            constexpr Long max_fab_header = 1024;
+            auto it = m_mapped_files.find(file_name);
+            const Long len = std::min(max_fab_header, it->second.second - offset);
+            hss.str(std::string(p + offset, len));
+            is = &hss;
+        } else {
+            ifs = VisMF::OpenStream(file_name);
+            ifs->seekg(offset, std::ios::beg);
+            is = ifs;
+        }
+        char c[4] = {0};
+        *is >> c[0] >> c[1] >> c[2] >> c[3];
+        bool ok = (c[0] == 'F' && c[1] == 'A' && c[2] == 'B' && c[3] != ':');  // ---- not the old format
+        if (ok) {
+            is->putback(c[3]);
+            Box bx;
+            int nvar;
+            *is >> rd >> bx >> nvar;
+            is->ignore(100000, '\n');
+            ok = is->good();
+            if (p) {
+                offset += static_cast<Long>(is->tellg());
+            } else {
+                offset = static_cast<Long>(is->tellg());
+            }
+        }
+        if (ifs) { VisMF::CloseStream(file_name); }
+        if (! ok) { return false; }
     } else {
-        int icomp = std::distance(std::begin(m_var_names), r);
-        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-            int gid = mfi.index();
-            FArrayBox& dstfab = mf[mfi];
-            std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
-            dstfab.copy<RunOn::Host>(*srcfab);
+        rd = hdr.m_writtenRD;
+    }
+
+    offset += icomp * npts * rd.numBytes();
+    return true;
+}
+
+void
+PlotFileDataImpl::readRegion (int level, int gid, int icomp, Box const& bx,
+                              FArrayBox& dst, int dcomp)
+{
+    const Box fabbox = amrex::grow(m_ba[level][gid], m_ngrow[level]);
+    AMREX_ASSERT(fabbox.contains(bx));
+
+    std::string file_name;
+    Long offset;
+    RealDescriptor rd;
+    if (! locateComponent(level, gid, icomp, file_name, offset, rd)) {
+        std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
+        dst.copy<RunOn::Host>(*srcfab, bx, 0, bx, dcomp, 1);
+        return;
+    }
+
+    // ---- read the cells from the first to the last cell of bx in the fab
+    const Long first = fabbox.index(bx.smallEnd());
+    const Long n = fabbox.index(bx.bigEnd()) - first + 1;
+    offset += first * rd.numBytes();
+    const bool native = (rd == FPC::NativeRealDescriptor());
+
+    Real const* src = nullptr;
+    Vector<Real> buf;
+    char const* p = m_memory_mapped ? mapFile(file_name) : nullptr;
+    if (p && native && offset % alignof(Real) == 0) {
+        src = reinterpret_cast<Real const*>(p + offset);
+    } else {
+        buf.resize(n);
+        if (p && native) {
+            std::memcpy(buf.data(), p + offset, n * sizeof(Real));
+        } else if (p) {
+            RealDescriptor::convertToNativeFormat(buf.data(), n, const_cast<char*>(p + offset), rd);
+        } else {
+            std::ifstream* ifs = VisMF::OpenStream(file_name);
+            ifs->seekg(offset, std::ios::beg);
+            if (native) {
+                ifs->read(reinterpret_cast<char*>(buf.data()), n * sizeof(Real));
+            } else {
+                RealDescriptor::convertToNativeFormat(buf.data(), n, *ifs, rd);
+            }
+            VisMF::CloseStream(file_name);
         }
+        src = buf.data();
     }
-    return mf;
+
+    const auto flo = amrex::lbound(fabbox);
+    const auto len = amrex::length(fabbox);
+    const auto blo = amrex::lbound(bx);
+    const auto bhi = amrex::ubound(bx);
+    auto const& d = dst.array(dcomp);
+    for         (int k = blo.z; k <= bhi.z; ++k) {
+        for     (int j = blo.y; j <= bhi.y; ++j) {
+            const Long row = ((k-flo.z)*Long(len.y) + (j-flo.y))*len.x - first - flo.x;
+            for (int i = blo.x; i <= bhi.x; ++i) {
+                d(i,j,k) = src[row+i];
+            }
+        }
+    }
+}
+
+char const*
+PlotFileDataImpl::mapFile (std::string const& file_name)
+{
+    auto it = m_mapped_files.find(file_name);
+    if (it != m_mapped_files.end()) {
+        return it->second.first;
+    }
+
+    char* p = nullptr;
+    Long size = 0;
+#ifndef _WIN32
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            size = static_cast<Long>(st.st_size);
+            // ---- private, so that writing to an alias does not change the file
+            void* a = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (a != MAP_FAILED) {
+                p = static_cast<char*>(a);
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    if (p) {
+        m_mapped_files[file_name] = std::make_pair(p, size);
+    }
+    return p;
+}
+
+void
+PlotFileDataImpl::unmapFiles ()
+{
+#ifndef _WIN32
+    for (auto& f : m_mapped_files) {
+        ::munmap(f.second.first, f.second.second);
+    }
+#endif
+    m_mapped_files.clear();
 }
 
 }
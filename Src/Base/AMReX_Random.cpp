@@ -116,6 +116,45 @@ amrex::ULong amrex::Random_long (amrex::ULong n)
     return distribution(generators[tid]);
 }
 
+void
+amrex::FillRandom (Real* p, Long n, ULong seed, ULong stream, unsigned int step)
+{
+    // Each 128-bit block gives two uniforms.
+    PhiloxEngine const engine(seed, stream, step);
+    const Long nfull = n/2;
+AMREX_PRAGMA_SIMD
+    for (Long ib = 0; ib < nfull; ++ib) {
+        auto r = engine.block(static_cast<std::uint32_t>(ib));
+        p[2*ib  ] = detail::philox_uniform((std::uint64_t(r[1]) << 32) | r[0]);
+        p[2*ib+1] = detail::philox_uniform((std::uint64_t(r[3]) << 32) | r[2]);
+    }
+    if (2*nfull < n) {
+        auto r = engine.block(static_cast<std::uint32_t>(nfull));
+        p[n-1] = detail::philox_uniform((std::uint64_t(r[1]) << 32) | r[0]);
+    }
+}
+
+void
+amrex::FillRandomNormal (Real* p, Long n, Real mean, Real stddev,
+                         ULong seed, ULong stream, unsigned int step)
+{
+    // Each 128-bit block gives two uniforms and thus two normals.
+    PhiloxEngine const engine(seed, stream, step);
+    const Long nblocks = (n+1)/2;
+    const Real twopi = Real(2.0)*Math::pi<Real>();
+AMREX_PRAGMA_SIMD
+    for (Long ib = 0; ib < nblocks; ++ib) {
+        auto r = engine.block(static_cast<std::uint32_t>(ib));
+        Real u1 = Real(1.0) - detail::philox_uniform((std::uint64_t(r[1]) << 32) | r[0]);
+        Real u2 = detail::philox_uniform((std::uint64_t(r[3]) << 32) | r[2]);
+        Real rad = stddev * std::sqrt(Real(-2.0)*std::log(u1));
+        p[2*ib] = mean + rad * std::cos(twopi*u2);
+        if (2*ib+1 < n) {
+            p[2*ib+1] = mean + rad * std::sin(twopi*u2);
+        }
+    }
+}
+
 void
 amrex::SaveRandomState (std::ostream& os)
 {
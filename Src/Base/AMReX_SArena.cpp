@@ -0,0 +1,290 @@
+#include <AMReX_SArena.H>
+#include <AMReX_Algorithm.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace amrex {
+
+namespace {
+    std::atomic<int> sarena_next_thread{0};
+    thread_local int sarena_thread = -1;
+
+    int sarena_thread_slot () noexcept
+    {
+        if (sarena_thread < 0) {
+            sarena_thread = sarena_next_thread++;
+        }
+        return sarena_thread % SArena::MaxThreadCaches;
+    }
+}
+
+int
+SArena::sizeClass (std::size_t nbytes) noexcept
+{
+    if (nbytes <= MinBlockSize) {
+        return 0;
+    }
+    // 2^(p-1) < nbytes <= 2^p, with four classes in between
+    const int p = 64 - amrex::clz(static_cast<std::uint64_t>(nbytes-1));
+    const std::size_t base = std::size_t(1) << (p-1);
+    const std::size_t step = std::size_t(1) << (p-3);
+    const int sub = static_cast<int>((nbytes - base + step - 1) / step);
+    return 1 + (p-7)*4 + (sub-1);
+}
+
+std::size_t
+SArena::classSize (int c) noexcept
+{
+    if (c == 0) {
+        return MinBlockSize;
+    }
+    const int p = (c-1)/4 + 7;
+    const int sub = (c-1)%4 + 1;
+    return (std::size_t(1) << (p-1)) + sub * (std::size_t(1) << (p-3));
+}
+
+SArena::SArena (std::size_t max_small_size, ArenaInfo info)
+    : m_backing(0, info),
+      m_max_small(max_small_size == 0 ? DefaultMaxSmallSize : max_small_size)
+{
+    arena_info = info;
+    m_max_small = std::max(m_max_small, MinBlockSize);
+    m_nclasses = sizeClass(m_max_small) + 1;
+    m_max_small = classSize(m_nclasses-1);
+    for (auto& c : m_caches) {
+        c.store(nullptr);
+    }
+}
+
+SArena::~SArena ()
+{
+    // The backing CArena returns the slabs and the large blocks to the system.
+    for (auto& c : m_caches) {
+        delete c.load();
+    }
+}
+
+SArena::ThreadCache&
+SArena::threadCache (int slot)
+{
+    ThreadCache* tc = m_caches[slot].load(std::memory_order_acquire);
+    if (tc == nullptr) {
+        auto* new_tc = new ThreadCache;
+        new_tc->freelist.resize(m_nclasses);
+        if (m_caches[slot].compare_exchange_strong(tc, new_tc, std::memory_order_acq_rel)) {
+            tc = new_tc;
+        } else {
+            delete new_tc;
+        }
+    }
+    return *tc;
+}
+
+void
+SArena::newSlab (ThreadCache& tc, int slot, int c)
+{
+    const std::size_t block = classSize(c);
+    const std::size_t nblocks = std::max(std::size_t(4), MinSlabSize/block);
+    const std::size_t nbytes = nblocks * block;
+
+    char* p = static_cast<char*>(m_backing.alloc(nbytes));
+    {
+        std::unique_lock<std::shared_mutex> lock(m_slabs_mutex);
+        m_slabs.emplace(p, Slab{nbytes, c, slot});
+    }
+    tc.slabs.push_back(p);
+
+    // Push in reverse so that the blocks are handed out from low to high addresses.
+    auto& fl = tc.freelist[c];
+    for (std::size_t i = nblocks; i > 0; --i) {
+        fl.push_back(p + (i-1)*block);
+    }
+}
+
+void*
+SArena::alloc (std::size_t nbytes)
+{
+    nbytes = (nbytes == 0) ? 1 : nbytes;
+
+    if (nbytes > m_max_small) {
+        nbytes = Arena::align(nbytes);
+        void* p = m_backing.alloc(nbytes);
+        {
+            std::lock_guard<std::mutex> lock(m_large_mutex);
+            m_large.emplace(p, nbytes);
+        }
+        m_actually_used += nbytes;
+        return p;
+    }
+
+    const int c = sizeClass(nbytes);
+    const int slot = sarena_thread_slot();
+    ThreadCache& tc = threadCache(slot);
+
+    std::lock_guard<std::mutex> lock(tc.mutex);
+    auto& fl = tc.freelist[c];
+    if (fl.empty()) {
+        newSlab(tc, slot, c);
+    }
+    void* p = fl.back();
+    fl.pop_back();
+    m_actually_used += classSize(c);
+    return p;
+}
+
+void
+SArena::free (void* vp)
+{
+    if (vp == nullptr) {
+        //
+        // Allow calls with NULL as allowed by C++ delete.
+        //
+        return;
+    }
+
+    int owner = -1;
+    int c = -1;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_slabs_mutex);
+        auto it = m_slabs.upper_bound(vp);
+        if (it != m_slabs.begin()) {
+            --it;
+            if (std::less<void*>()(vp, static_cast<char*>(it->first) + it->second.size)) {
+                owner = it->second.owner;
+                c = it->second.size_class;
+            }
+        }
+    }
+
+    if (owner >= 0) {
+        // The block goes back to the cache that owns its slab.
+        ThreadCache& tc = *m_caches[owner].load(std::memory_order_acquire);
+        std::lock_guard<std::mutex> lock(tc.mutex);
+        tc.freelist[c].push_back(vp);
+        m_actually_used -= classSize(c);
+    } else {
+        std::size_t nbytes;
+        {
+            std::lock_guard<std::mutex> lock(m_large_mutex);
+            auto it = m_large.find(vp);
+            if (it == m_large.end()) {
+                amrex::Abort("SArena::free: unknown pointer");
+                return;
+            }
+            nbytes = it->second;
+            m_large.erase(it);
+        }
+        m_actually_used -= nbytes;
+        m_backing.free(vp);
+    }
+}
+
+std::size_t
+SArena::freeUnused ()
+{
+    for (auto& cache : m_caches) {
+        ThreadCache* tc = cache.load(std::memory_order_acquire);
+        if (tc == nullptr) continue;
+
+        std::lock_guard<std::mutex> lock(tc->mutex);
+        for (auto& fl : tc->freelist) {
+            std::sort(fl.begin(), fl.end(), std::less<void*>());
+        }
+
+        auto it = std::remove_if(tc->slabs.begin(), tc->slabs.end(),
+            [&] (void* p)
+            {
+                Slab slab;
+                {
+                    std::shared_lock<std::shared_mutex> slock(m_slabs_mutex);
+                    slab = m_slabs.at(p);
+                }
+                auto& fl = tc->freelist[slab.size_class];
+                char* end = static_cast<char*>(p) + slab.size;
+                auto lo = std::lower_bound(fl.begin(), fl.end(), p, std::less<void*>());
+                auto hi = std::lower_bound(lo, fl.end(), static_cast<void*>(end),
+                                           std::less<void*>());
+                if (static_cast<std::size_t>(hi-lo) * classSize(slab.size_class) != slab.size) {
+                    return false;
+                }
+                fl.erase(lo, hi);
+                {
+                    std::unique_lock<std::shared_mutex> ulock(m_slabs_mutex);
+                    m_slabs.erase(p);
+                }
+                m_backing.free(p);
+                return true;
+            });
+        tc->slabs.erase(it, tc->slabs.end());
+
+        // Keep handing out blocks from low to high addresses.
+        for (auto& fl : tc->freelist) {
+            std::reverse(fl.begin(), fl.end());
+        }
+    }
+
+    return m_backing.freeUnused();
+}
+
+bool
+SArena::hasFreeDeviceMemory (std::size_t sz)
+{
+    return m_backing.hasFreeDeviceMemory(sz);
+}
+
+std::size_t
+SArena::heap_space_used () const noexcept
+{
+    return m_backing.heap_space_used();
+}
+
+std::size_t
+SArena::heap_space_actually_used () const noexcept
+{
+    return m_actually_used.load();
+}
+
+void
+SArena::PrintUsage (std::string const& name) const
+{
+    Long min_megabytes = heap_space_used() / (1024*1024);
+    Long max_megabytes = min_megabytes;
+    Long actual_min_megabytes = heap_space_actually_used() / (1024*1024);
+    Long actual_max_megabytes = actual_min_megabytes;
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+    ParallelReduce::Min<Long>({min_megabytes, actual_min_megabytes},
+                              IOProc, ParallelDescriptor::Communicator());
+    ParallelReduce::Max<Long>({max_megabytes, actual_max_megabytes},
+                              IOProc, ParallelDescriptor::Communicator());
+#ifdef AMREX_USE_MPI
+    amrex::Print() << "[" << name << "] space (MB) allocated spread across MPI: ["
+                   << min_megabytes << " ... " << max_megabytes << "]\n"
+                   << "[" << name << "] space (MB) used      spread across MPI: ["
+                   << actual_min_megabytes << " ... " << actual_max_megabytes << "]\n";
+#else
+    amrex::Print() << "[" << name << "] space allocated (MB): " << min_megabytes << "\n";
+    amrex::Print() << "[" << name << "] space used      (MB): " << actual_min_megabytes << "\n";
+#endif
+}
+
+void
+SArena::PrintUsage (std::ostream& os, std::string const& name, std::string const& space) const
+{
+    Long megabytes = heap_space_used() / (1024*1024);
+    Long actual_megabytes = heap_space_actually_used() / (1024*1024);
+    std::size_t nslabs;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_slabs_mutex);
+        nslabs = m_slabs.size();
+    }
+    os << space << "[" << name << "] space allocated (MB): " << megabytes << "\n";
+    os << space << "[" << name << "] space used      (MB): " << actual_megabytes << "\n";
+    os << space << "[" << name << "]: " << nslabs << " slabs, "
+       << m_nclasses << " size classes up to " << m_max_small << " bytes\n";
+}
+
+}
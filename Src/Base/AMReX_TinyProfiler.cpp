@@ -10,6 +10,7 @@
 #include <AMReX_GpuDevice.H>
 #endif
 #include <AMReX_Print.H>
+#include <AMReX_OpenMP.H>
 
 #ifdef AMREX_USE_CUPTI
 #include <AMReX_CuptiTrace.H>
@@ -20,10 +21,23 @@
 #include <omp.h>
 #endif
 
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
+#include <cerrno>
 #include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <mutex>
 #include <set>
 
 namespace amrex {
@@ -35,10 +49,195 @@ double TinyProfiler::t_init = std::numeric_limits<double>::max();
 int TinyProfiler::device_synchronize_around_region = 0;
 int TinyProfiler::n_print_tabs = 0;
 int TinyProfiler::verbose = 0;
+int TinyProfiler::perf_counters = 0;
+int TinyProfiler::trace = 0;
 
 namespace {
     std::set<std::string> improperly_nested_timers;
     static constexpr char mainregion[] = "main";
+
+    using HWCounts = TinyProfiler::HWCounts;
+
+    // counts when the timer was started, and accumulated counts of children
+    std::deque<std::pair<HWCounts,HWCounts> > hwstack;
+    bool has_flops_counter = false;
+    Long cache_line_size = 64;
+
+#ifdef __linux__
+    // One group of counters per OpenMP thread, each opened by its thread,
+    // because a counter opened for the calling thread does not count the
+    // other threads of the process.
+    std::vector<std::array<int,TinyProfiler::NHWCounters> > hw_fd;
+
+    int hw_open_counter (std::uint32_t type, std::uint64_t config, int group_fd)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+            | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+#endif
+
+    //! Open the counters for every OpenMP thread.  Returns false if the required ones are not available.
+    bool hw_open (std::uint64_t flops_event)
+    {
+#ifdef __linux__
+        std::array<int,TinyProfiler::NHWCounters> none;
+        none.fill(-1);
+        hw_fd.assign(OpenMP::get_max_threads(), none);
+        bool ok = true;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel reduction(&&:ok)
+#endif
+        {
+            auto& fd = hw_fd[OpenMP::get_thread_num()];
+            fd[TinyProfiler::HWCycles] = hw_open_counter(PERF_TYPE_HARDWARE,
+                                                         PERF_COUNT_HW_CPU_CYCLES, -1);
+            const int leader = fd[TinyProfiler::HWCycles];
+            if (leader >= 0) {
+                fd[TinyProfiler::HWInstructions] = hw_open_counter(PERF_TYPE_HARDWARE,
+                                                                   PERF_COUNT_HW_INSTRUCTIONS, leader);
+                fd[TinyProfiler::HWCacheMisses] = hw_open_counter(PERF_TYPE_HARDWARE,
+                                                                  PERF_COUNT_HW_CACHE_MISSES, leader);
+                if (flops_event != 0) {
+                    fd[TinyProfiler::HWFlops] = hw_open_counter(PERF_TYPE_RAW, flops_event, leader);
+                }
+            }
+            ok = ok && leader >= 0 && fd[TinyProfiler::HWInstructions] >= 0
+                && fd[TinyProfiler::HWCacheMisses] >= 0;
+        }
+        long line_size = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+        if (line_size > 0) { cache_line_size = line_size; }
+        return ok;
+#else
+        amrex::ignore_unused(flops_event);
+        return false;
+#endif
+    }
+
+    void hw_close ()
+    {
+#ifdef __linux__
+        for (auto& group : hw_fd) {
+            for (int& fd : group) {
+                if (fd >= 0) { close(fd); }
+                fd = -1;
+            }
+        }
+        hw_fd.clear();
+#endif
+    }
+
+    //! Current counts summed over the threads, scaled up if the kernel had to multiplex the counters.
+    HWCounts hw_read ()
+    {
+        HWCounts r{};
+#ifdef __linux__
+        for (auto const& fd : hw_fd) {
+            // nr, time_enabled, time_running, and one value per open counter in the order of opening.
+            std::uint64_t buf[3+TinyProfiler::NHWCounters];
+            if (read(fd[TinyProfiler::HWCycles], buf, sizeof(buf)) > 0) {
+                const double scale = (buf[2] > 0 && buf[2] < buf[1])
+                    ? static_cast<double>(buf[1]) / static_cast<double>(buf[2]) : 1.0;
+                std::uint64_t n = 0;
+                for (int i = 0; i < TinyProfiler::NHWCounters && n < buf[0]; ++i) {
+                    if (fd[i] >= 0) {
+                        r[i] += static_cast<Long>(static_cast<double>(buf[3+n]) * scale);
+                        ++n;
+                    }
+                }
+            }
+        }
+#endif
+        return r;
+    }
+
+    void hw_push ()
+    {
+        hwstack.emplace_back(hw_read(), HWCounts{});
+    }
+
+    //! Pop the innermost timer and return its exclusive counts.
+    HWCounts hw_pop ()
+    {
+        const HWCounts now = hw_read();
+        HWCounts ex;
+        HWCounts in;
+        for (int i = 0; i < TinyProfiler::NHWCounters; ++i) {
+            in[i] = now[i] - hwstack.back().first[i];
+            ex[i] = in[i] - hwstack.back().second[i];
+        }
+        hwstack.pop_back();
+        if (!hwstack.empty()) {
+            for (int i = 0; i < TinyProfiler::NHWCounters; ++i) {
+                hwstack.back().second[i] += in[i];
+            }
+        }
+        return ex;
+    }
+
+    struct TraceEvent
+    {
+        const char* name;
+        double t_start;
+        double t_stop;
+        bool wait;
+    };
+
+    //! The most recent events of one thread.
+    struct TraceBuffer
+    {
+        int tid = 0;
+        Long nrecorded = 0;
+        double wait_time = 0.0;
+        std::vector<TraceEvent> events;
+    };
+
+    int trace_buffer_size = 65536;
+    std::string trace_dir("tiny_profiler_trace");
+    std::mutex trace_mutex;
+    std::vector<std::unique_ptr<TraceBuffer> > trace_buffers;
+    thread_local TraceBuffer* my_trace_buffer = nullptr;
+
+    void trace_record (const char* name, double t_start, double t_stop, bool wait)
+    {
+        if (my_trace_buffer == nullptr) {
+            std::lock_guard<std::mutex> lock(trace_mutex);
+            trace_buffers.emplace_back(std::make_unique<TraceBuffer>());
+            my_trace_buffer = trace_buffers.back().get();
+#ifdef AMREX_USE_OMP
+            my_trace_buffer->tid = omp_get_thread_num();
+#endif
+            my_trace_buffer->events.resize(trace_buffer_size);
+        }
+        TraceBuffer& b = *my_trace_buffer;
+        b.events[b.nrecorded % trace_buffer_size] = TraceEvent{name, t_start, t_stop, wait};
+        ++b.nrecorded;
+        if (wait) {
+            b.wait_time += t_stop - t_start;
+        }
+    }
+
+    void trace_write_string (std::ostream& os, const char* str)
+    {
+        os << '"';
+        for (const char* c = str; *c != '\0'; ++c) {
+            if (*c == '"' || *c == '\\') {
+                os << '\\' << *c;
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                os << ' ';
+            } else {
+                os << *c;
+            }
+        }
+        os << '"';
+    }
 }
 
 TinyProfiler::TinyProfiler (std::string funcname) noexcept
@@ -92,6 +291,9 @@ TinyProfiler::start () noexcept
 
         ttstack.emplace_back(std::make_tuple(t, 0.0, &fname));
         global_depth = ttstack.size();
+        if (perf_counters) {
+            hw_push();
+        }
 
 #ifdef AMREX_USE_GPU
             if (device_synchronize_around_region) {
@@ -112,6 +314,10 @@ TinyProfiler::start () noexcept
             stats.push_back(&st);
         }
 
+        if (trace && trace_name == nullptr) {
+            trace_name = statsmap[regionstack.front()].find(fname)->first.c_str();
+        }
+
         if (verbose) {
             ++n_print_tabs;
             std::string whitespace;
@@ -148,6 +354,9 @@ TinyProfiler::stop () noexcept
         while (static_cast<int>(ttstack.size()) > global_depth) {
             ttstack.pop_back();
         };
+        while (static_cast<int>(hwstack.size()) > global_depth) {
+            hwstack.pop_back();
+        }
 
         if (static_cast<int>(ttstack.size()) == global_depth)
         {
@@ -165,6 +374,11 @@ TinyProfiler::stop () noexcept
                 dtex = dtin - std::get<1>(tt);
             }
 
+            HWCounts hwex{};
+            if (perf_counters) {
+                hwex = hw_pop();
+            }
+
             for (Stats* st : stats)
             {
                 --(st->depth);
@@ -177,6 +391,13 @@ TinyProfiler::stop () noexcept
                 if (uCUPTI) {
                     st->nk += nKernelCalls;
                 }
+                for (int i = 0; i < NHWCounters; ++i) {
+                    st->hwex[i] += hwex[i];
+                }
+            }
+
+            if (trace && !uCUPTI && trace_name != nullptr) {
+                trace_record(trace_name, std::get<0>(tt), t, false);
             }
 
             ttstack.pop_back();
@@ -237,6 +458,10 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
         {
             ttstack.pop_back();
         };
+        while (static_cast<int>(hwstack.size()) > global_depth)
+        {
+            hwstack.pop_back();
+        }
 
         if (static_cast<int>(ttstack.size()) == global_depth)
         {
@@ -250,6 +475,11 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
             dtin = t;
             dtex = dtin - std::get<1>(tt);
 
+            HWCounts hwex{};
+            if (perf_counters) {
+                hwex = hw_pop();
+            }
+
             for (Stats* st : stats)
             {
                 --(st->depth);
@@ -261,6 +491,9 @@ TinyProfiler::stop (unsigned boxUintID) noexcept
                 st->dtex += dtex;
                 st->usesCUPTI = uCUPTI;
                 st->nk += nKernelCalls;
+                for (int i = 0; i < NHWCounters; ++i) {
+                    st->hwex[i] += hwex[i];
+                }
             }
 
             ttstack.pop_back();
@@ -303,6 +536,59 @@ TinyProfiler::Initialize () noexcept
         pp.queryAdd("device_synchronize_around_region", device_synchronize_around_region);
         pp.queryAdd("verbose", verbose);
         pp.queryAdd("v", verbose);
+        pp.queryAdd("perf_counters", perf_counters);
+        pp.queryAdd("trace", trace);
+        pp.queryAdd("trace_buffer_size", trace_buffer_size);
+        pp.queryAdd("trace_dir", trace_dir);
+
+        if (trace) {
+            AMREX_ALWAYS_ASSERT(trace_buffer_size > 0);
+            for (auto& b : trace_buffers) {
+                b->nrecorded = 0;
+                b->wait_time = 0.0;
+                b->events.resize(trace_buffer_size);
+            }
+            // so that the timelines of the processes start together
+            ParallelDescriptor::Barrier();
+            t_init = amrex::second();
+        }
+
+        if (perf_counters) {
+            // The config of a raw, processor specific event that counts floating point
+            // operations, as a decimal or 0x prefixed hexadecimal number.
+            std::string flops_event;
+            pp.query("perf_flops_event", flops_event);
+            std::uint64_t flops_config = 0;
+            if (!flops_event.empty()) {
+                char* end = nullptr;
+                errno = 0;
+                flops_config = std::strtoull(flops_event.c_str(), &end, 0);
+                if (errno != 0 || end == flops_event.c_str() || *end != '\0'
+                    || flops_event.find('-') != std::string::npos)
+                {
+                    amrex::Abort("TinyProfiler: tiny_profiler.perf_flops_event = " + flops_event
+                                 + " is not a decimal or 0x prefixed hexadecimal event config");
+                }
+            }
+            bool ok = hw_open(flops_config);
+            ParallelDescriptor::ReduceBoolAnd(ok);
+            if (ok) {
+#ifdef __linux__
+                has_flops_counter = std::all_of(hw_fd.begin(), hw_fd.end(),
+                    [] (auto const& fd) { return fd[HWFlops] >= 0; });
+#endif
+                ParallelDescriptor::ReduceBoolAnd(has_flops_counter);
+                if (!flops_event.empty() && !has_flops_counter) {
+                    amrex::Print() << "TinyProfiler: could not open tiny_profiler.perf_flops_event "
+                                   << flops_event << "\n";
+                }
+            } else {
+                hw_close();
+                perf_counters = 0;
+                amrex::Print() << "TinyProfiler: hardware counters are not available, "
+                               << "tiny_profiler.perf_counters is ignored\n";
+            }
+        }
     }
 }
 
@@ -320,6 +606,14 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
 
     double t_final = amrex::second();
 
+    // the counters stop with the final report
+    const bool print_hw = perf_counters != 0;
+    if (!bFlushing && perf_counters) {
+        perf_counters = 0;
+        hw_close();
+        hwstack.clear();
+    }
+
     // make a local copy so that any functions call after this will not be recorded in the local copy.
     auto lstatsmap = statsmap;
 
@@ -384,18 +678,88 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
         }
     }
 
-    PrintStats(lstatsmap[mainregion], dt_max);
+    PrintStats(lstatsmap[mainregion], dt_max, print_hw);
     for (auto& kv : lstatsmap) {
         if (kv.first != mainregion) {
             amrex::Print() << "\n\nBEGIN REGION " << kv.first << "\n";
-            PrintStats(kv.second, dt_max);
+            PrintStats(kv.second, dt_max, print_hw);
             amrex::Print() << "END REGION " << kv.first << "\n";
         }
     }
+
+    if (!bFlushing && trace) {
+        WriteTrace();
+        trace = 0;
+    }
+}
+
+void
+TinyProfiler::WriteTrace ()
+{
+    const int myproc = ParallelDescriptor::MyProc();
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+
+    double wait_time = 0.0;
+    for (auto const& b : trace_buffers) {
+        wait_time = std::max(wait_time, b->wait_time);
+    }
+    double wait_min = wait_time, wait_avg = wait_time, wait_max = wait_time;
+    ParallelReduce::Min(wait_min, ioproc, ParallelDescriptor::Communicator());
+    ParallelReduce::Sum(wait_avg, ioproc, ParallelDescriptor::Communicator());
+    ParallelReduce::Max(wait_max, ioproc, ParallelDescriptor::Communicator());
+    wait_avg /= double(ParallelDescriptor::NProcs());
+    amrex::Print().SetPrecision(4)
+        << "TinyProfiler MPI wait time across processes [min...avg...max]: "
+        << wait_min << " ... " << wait_avg << " ... " << wait_max << "\n";
+
+    amrex::UtilCreateCleanDirectory(trace_dir, true);
+
+    // Chrome trace event format, JSON array.  The arrays of all the
+    // processes can be concatenated into one trace.
+    const std::string file_name = trace_dir + "/" + amrex::Concatenate("trace_", myproc, 5) + ".json";
+    std::ofstream ofs(file_name);
+    if (!ofs.good()) {
+        amrex::FileOpenFailed(file_name);
+    }
+    ofs << std::fixed << std::setprecision(3);
+    ofs << "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << myproc
+        << ",\"args\":{\"name\":\"rank " << myproc << "\"}},\n"
+        << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << myproc
+        << ",\"args\":{\"sort_index\":" << myproc << "}}";
+    for (auto const& b : trace_buffers) {
+        const Long nevents = std::min(b->nrecorded, Long(trace_buffer_size));
+        if (b->nrecorded > nevents) {
+            ofs << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << myproc
+                << ",\"tid\":" << b->tid << ",\"args\":{\"name\":\"thread " << b->tid
+                << " (last " << nevents << " of " << b->nrecorded << " events)\"}}";
+        }
+        for (Long i = b->nrecorded - nevents; i < b->nrecorded; ++i) {
+            TraceEvent const& e = b->events[i % trace_buffer_size];
+            ofs << ",\n{\"name\":";
+            trace_write_string(ofs, e.name);
+            ofs << ",\"cat\":\"" << (e.wait ? "wait" : "timer")
+                << "\",\"ph\":\"X\",\"pid\":" << myproc << ",\"tid\":" << b->tid
+                << ",\"ts\":" << (e.t_start-t_init)*1.e6
+                << ",\"dur\":" << (e.t_stop-e.t_start)*1.e6 << "}";
+        }
+    }
+    ofs << "\n]\n";
+    ofs.close();
+
+    amrex::Print() << "TinyProfiler trace written to " << trace_dir << "\n";
 }
 
 void
-TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
+TinyProfiler::RecordWait (const char* name, double t_start, double t_stop) noexcept
+{
+    if (trace) {
+        trace_record(name, t_start, t_stop, true);
+    }
+}
+
+void
+TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max,
+                          bool print_hw)
 {
     // make sure the set of profiled functions is the same on all processes
     {
@@ -430,20 +794,28 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
     for (auto it = regstats.cbegin(); it != regstats.cend(); ++it)
     {
         Long n = it->second.n;
-        double dts[2] = {it->second.dtin, it->second.dtex};
+        // dtin, dtex, and the exclusive hardware counts
+        const int nv = print_hw ? 2+NHWCounters : 2;
+        std::vector<double> dts(nv);
+        dts[0] = it->second.dtin;
+        dts[1] = it->second.dtex;
+        for (int i = 2; i < nv; ++i) {
+            dts[i] = static_cast<double>(it->second.hwex[i-2]);
+        }
 
         std::vector<Long> ncalls(nprocs);
-        std::vector<double> dtdt(2*nprocs);
+        std::vector<double> dtdt(nv*nprocs);
 
         if (ParallelDescriptor::NProcs() == 1)
         {
             ncalls[0] = n;
-            dtdt[0] = dts[0];
-            dtdt[1] = dts[1];
+            for (int i = 0; i < nv; ++i) {
+                dtdt[i] = dts[i];
+            }
         } else
         {
             ParallelDescriptor::Gather(&n, 1, &ncalls[0], 1, ioproc);
-            ParallelDescriptor::Gather(dts, 2, &dtdt[0], 2, ioproc);
+            ParallelDescriptor::Gather(dts.data(), nv, &dtdt[0], nv, ioproc);
         }
 
         if (ParallelDescriptor::IOProcessor()) {
@@ -452,16 +824,40 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
                 pst.nmin  = std::min(pst.nmin, ncalls[i]);
                 pst.navg +=                    ncalls[i];
                 pst.nmax  = std::max(pst.nmax, ncalls[i]);
-                pst.dtinmin  = std::min(pst.dtinmin, dtdt[2*i]);
-                pst.dtinavg +=                       dtdt[2*i];
-                pst.dtinmax  = std::max(pst.dtinmax, dtdt[2*i]);
-                pst.dtexmin  = std::min(pst.dtexmin, dtdt[2*i+1]);
-                pst.dtexavg +=                       dtdt[2*i+1];
-                pst.dtexmax  = std::max(pst.dtexmax, dtdt[2*i+1]);
+                pst.dtinmin  = std::min(pst.dtinmin, dtdt[nv*i]);
+                pst.dtinavg +=                       dtdt[nv*i];
+                pst.dtinmax  = std::max(pst.dtinmax, dtdt[nv*i]);
+                pst.dtexmin  = std::min(pst.dtexmin, dtdt[nv*i+1]);
+                pst.dtexavg +=                       dtdt[nv*i+1];
+                pst.dtexmax  = std::max(pst.dtexmax, dtdt[nv*i+1]);
+                if (print_hw) {
+                    // rates derived on each process, then min/avg/max over processes
+                    const double dtex = dtdt[nv*i+1];
+                    const double* hw = &dtdt[nv*i+2];
+                    const double ipc = hw[HWCycles] > 0.
+                        ? hw[HWInstructions]/hw[HWCycles] : 0.;
+                    const double bw = dtex > 0.
+                        ? hw[HWCacheMisses]*static_cast<double>(cache_line_size)/dtex*1.e-9 : 0.;
+                    const double flops = dtex > 0. ? hw[HWFlops]/dtex*1.e-9 : 0.;
+                    pst.instravg += hw[HWInstructions];
+                    pst.ipcmin    = std::min(pst.ipcmin, ipc);
+                    pst.ipcavg   +=                      ipc;
+                    pst.ipcmax    = std::max(pst.ipcmax, ipc);
+                    pst.bwmin     = std::min(pst.bwmin, bw);
+                    pst.bwavg    +=                     bw;
+                    pst.bwmax     = std::max(pst.bwmax, bw);
+                    pst.flopsmin  = std::min(pst.flopsmin, flops);
+                    pst.flopsavg +=                        flops;
+                    pst.flopsmax  = std::max(pst.flopsmax, flops);
+                }
             }
             pst.navg /= nprocs;
             pst.dtinavg /= nprocs;
             pst.dtexavg /= nprocs;
+            pst.instravg /= nprocs;
+            pst.ipcavg /= nprocs;
+            pst.bwavg /= nprocs;
+            pst.flopsavg /= nprocs;
             pst.fname = it->first;
 #ifdef AMREX_USE_CUPTI
             pst.usesCUPTI = it->second.usesCUPTI;
@@ -587,6 +983,57 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
 #endif
         }
         amrex::OutStream() << hline << "\n";
+
+        // Hardware counters, exclusive.  GB/s assumes that every last level
+        // cache miss moves one cache line.
+        if (print_hw)
+        {
+            std::sort(allprocstats.begin(), allprocstats.end(), ProcStats::compex);
+            int wi = std::max(wt, int(std::string("Instr. Avg").size()));
+            int wr = std::max(wt, int(std::string("GFLOPS Min").size()));
+            const int nrates = has_flops_counter ? 9 : 6;
+            const std::string hwline(maxfnamelen+wnc+2+wi+2+(wr+2)*nrates,'-');
+            amrex::OutStream() << "\n" << hwline << "\n";
+            amrex::OutStream() << std::left
+                               << std::setw(maxfnamelen) << "Name"
+                               << std::right
+                               << std::setw(wnc+2) << "NCalls"
+                               << std::setw(wi+2) << "Instr. Avg"
+                               << std::setw(wr+2) << "IPC Min"
+                               << std::setw(wr+2) << "IPC Avg"
+                               << std::setw(wr+2) << "IPC Max"
+                               << std::setw(wr+2) << "GB/s Min"
+                               << std::setw(wr+2) << "GB/s Avg"
+                               << std::setw(wr+2) << "GB/s Max";
+            if (has_flops_counter) {
+                amrex::OutStream() << std::setw(wr+2) << "GFLOPS Min"
+                                   << std::setw(wr+2) << "GFLOPS Avg"
+                                   << std::setw(wr+2) << "GFLOPS Max";
+            }
+            amrex::OutStream() << "\n" << hwline << "\n";
+            for (auto it = allprocstats.cbegin(); it != allprocstats.cend(); ++it)
+            {
+                amrex::OutStream() << std::setprecision(4) << std::left
+                                   << std::setw(maxfnamelen) << it->fname
+                                   << std::right
+                                   << std::setw(wnc+2) << it->navg
+                                   << std::setw(wi+2) << it->instravg
+                                   << std::setw(wr+2) << it->ipcmin
+                                   << std::setw(wr+2) << it->ipcavg
+                                   << std::setw(wr+2) << it->ipcmax
+                                   << std::setw(wr+2) << it->bwmin
+                                   << std::setw(wr+2) << it->bwavg
+                                   << std::setw(wr+2) << it->bwmax;
+                if (has_flops_counter) {
+                    amrex::OutStream() << std::setw(wr+2) << it->flopsmin
+                                       << std::setw(wr+2) << it->flopsavg
+                                       << std::setw(wr+2) << it->flopsmax;
+                }
+                amrex::OutStream() << "\n";
+            }
+            amrex::OutStream() << hwline << "\n";
+        }
+
         amrex::OutStream() << std::endl;
     }
 }
@@ -607,6 +1054,17 @@ TinyProfiler::StopRegion (const std::string& regname) noexcept
     }
 }
 
+TinyProfileWait::TinyProfileWait (const char* a_name) noexcept
+    : name(a_name), t_start(TinyProfiler::Tracing() ? amrex::second() : 0.0)
+{}
+
+TinyProfileWait::~TinyProfileWait ()
+{
+    if (TinyProfiler::Tracing()) {
+        TinyProfiler::RecordWait(name, t_start, amrex::second());
+    }
+}
+
 TinyProfileRegion::TinyProfileRegion (std::string a_regname) noexcept
     : regname(std::move(a_regname)),
       tprof(std::string("REG::")+regname, false, false)
@@ -1,13 +1,18 @@
 
 #include <AMReX_FabArrayUtility.H>
+#include <AMReX_FabCompression.H>
 #include <AMReX_FPC.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
 #include <AMReX_VisMF.H>
 
 #include <cerrno>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <future>
 #include <limits>
+#include <tuple>
 
 namespace amrex {
 
@@ -28,6 +33,10 @@ bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
 bool VisMF::allowSparseWrites(true);
+bool VisMF::useAggregatedReads(false);
+int  VisMF::nReaders(0);
+Long VisMF::readAggregateSize(64*1024*1024);
+Real VisMF::compressionTolerance(0.0);
 
 Long VisMFBuffer::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -76,6 +85,10 @@ VisMF::Initialize ()
     pp.queryAdd("usedynamicsetselection", useDynamicSetSelection);
     pp.queryAdd("iobuffersize", ioBufferSize);
     pp.queryAdd("allowsparsewrites", allowSparseWrites);
+    pp.queryAdd("useaggregatedreads", useAggregatedReads);
+    pp.queryAdd("nreaders", nReaders);
+    pp.queryAdd("readaggregatesize", readAggregateSize);
+    pp.queryAdd("compressiontolerance", compressionTolerance);
 
     initialized = true;
 }
@@ -124,10 +137,22 @@ operator>> (std::istream& is, VisMF::FabOnDisk& fod)
 
     BL_ASSERT(str == TheFabOnDiskPrefix);
 
-    is >> fod.m_name;
-    is >> fod.m_head;
+    // The offset is the last word of the line.  The file name is the rest,
+    // which may contain spaces, e.g., "Not Saved" from WriteOnlyHeader.
+    std::string line;
+    std::getline(is, line);
+    const auto last = line.find_last_not_of(" \t\r");
+    const auto sep = (last == std::string::npos)
+        ? std::string::npos : line.find_last_of(" \t", last);
+    const auto first = line.find_first_not_of(" \t");
+    if (sep == std::string::npos || first >= sep) {
+        amrex::Error("Read of VisMF::FabOnDisk failed");
+    }
+    fod.m_name = line.substr(first, line.find_last_not_of(" \t", sep) + 1 - first);
+    std::istringstream head(line.substr(sep+1, last-sep));
+    head >> fod.m_head;
 
-    if( ! is.good()) {
+    if( ! is.good() || head.fail()) {
         amrex::Error("Read of VisMF::FabOnDisk failed");
     }
 
@@ -293,6 +318,17 @@ operator<< (std::ostream        &os,
       os << '\n';
     }
 
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      BL_ASSERT(hd.m_fabBytes.size() == hd.m_ba.size());
+      os << hd.m_tolerance << '\n';
+      for(int i(0); i < hd.m_fabBytes.size(); ++i) {
+        os << hd.m_fabBytes[i] << ',';
+      }
+      os << '\n';
+      // ---- the fabs are always compressed in the native format
+      os << FPC::NativeRealDescriptor() << '\n';
+    }
+
     if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
        hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
@@ -383,9 +419,21 @@ operator>> (std::istream  &is,
         }
       }
     }
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      char ch;
+      is >> hd.m_tolerance;
+      hd.m_fabBytes.resize(hd.m_ba.size());
+      for(int i(0); i < hd.m_fabBytes.size(); ++i) {
+        is >> hd.m_fabBytes[i] >> ch;
+        if( ch != ',' ) {
+          amrex::Error("Expected a ',' when reading hd.m_fabBytes");
+        }
+      }
+    }
     if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_writtenRD;
     }
@@ -649,7 +697,7 @@ VisMF::Header::Header (const FabArray<FArrayBox>& mf,
 {
 //    BL_PROFILE("VisMF::Header");
 
-    if(version == NoFabHeader_v1) {
+    if(version == NoFabHeader_v1 || version == Compressed_v1) {
       m_min.clear();
       m_max.clear();
       m_famin.clear();
@@ -914,6 +962,119 @@ VisMF::WriteHeader (const std::string &mf_name, VisMF::Header &hdr,
 }
 
 
+namespace {
+
+// ---- A compressed fab starts with the compressed sizes of its components,
+// ---- followed by the components compressed separately, so that a single
+// ---- component can be read without reading the others.
+using CompBytes_t = std::int64_t;
+
+Vector<Vector<char> >
+CompressFabs (const FabArray<FArrayBox> &mf, Real tolerance)
+{
+    BL_PROFILE("VisMF::CompressFabs");
+
+    Vector<Real const*> fabData;
+    Vector<Long> fabPts;
+#ifdef AMREX_USE_GPU
+    Vector<std::unique_ptr<FArrayBox> > hostFabs;
+#endif
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const FArrayBox &fab = mf[mfi];
+        Real const* fabdata = fab.dataPtr();
+#ifdef AMREX_USE_GPU
+        if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+            hostFabs.push_back(std::make_unique<FArrayBox>(fab.box(), fab.nComp(),
+                                                           The_Pinned_Arena()));
+            Gpu::dtoh_memcpy_async(hostFabs.back()->dataPtr(), fab.dataPtr(),
+                                   fab.size()*sizeof(Real));
+            Gpu::streamSynchronize();
+            fabdata = hostFabs.back()->dataPtr();
+        }
+#endif
+        fabData.push_back(fabdata);
+        fabPts.push_back(fab.box().numPts());
+    }
+
+    // ---- compress the components of all fabs in parallel
+    const int nFABs(fabData.size()), nComp(mf.nComp());
+    Vector<Vector<char> > compData(nFABs * nComp);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(int i = 0; i < nFABs * nComp; ++i) {
+        const int ifab(i / nComp), comp(i % nComp);
+        FabCompression::compress(fabData[ifab] + comp * fabPts[ifab], fabPts[ifab],
+                                 static_cast<double>(tolerance), compData[i]);
+    }
+
+    Vector<Vector<char> > fabChunks(nFABs);
+    for(int ifab(0); ifab < nFABs; ++ifab) {
+        Vector<CompBytes_t> compBytes(nComp);
+        Long nbytes(nComp * sizeof(CompBytes_t));
+        for(int comp(0); comp < nComp; ++comp) {
+            compBytes[comp] = compData[ifab*nComp + comp].size();
+            nbytes += compBytes[comp];
+        }
+        Vector<char> &chunk = fabChunks[ifab];
+        chunk.resize(nbytes);
+        std::memcpy(chunk.dataPtr(), compBytes.dataPtr(), nComp * sizeof(CompBytes_t));
+        char *dst = chunk.dataPtr() + nComp * sizeof(CompBytes_t);
+        for(int comp(0); comp < nComp; ++comp) {
+            Vector<char> &cd = compData[ifab*nComp + comp];
+            std::memcpy(dst, cd.dataPtr(), cd.size());
+            dst += cd.size();
+            Vector<char>().swap(cd);
+        }
+    }
+    return fabChunks;
+}
+
+// ---- Decompress one component written with the real descriptor rd.
+void
+DecompressComponent (const char *src, Long nbytes, const RealDescriptor &rd,
+                     Real *dst, Long npts)
+{
+    if(rd.numBytes() == static_cast<int>(sizeof(Real))) {
+        FabCompression::decompress(src, nbytes, dst, npts);
+    } else if(rd.numBytes() == static_cast<int>(sizeof(float))) {
+        Vector<float> tmp(npts);
+        FabCompression::decompress(src, nbytes, tmp.dataPtr(), npts);
+        std::copy(tmp.begin(), tmp.end(), dst);
+    } else {
+        Vector<double> tmp(npts);
+        FabCompression::decompress(src, nbytes, tmp.dataPtr(), npts);
+        for(Long i(0); i < npts; ++i) {
+            dst[i] = static_cast<Real>(tmp[i]);
+        }
+    }
+}
+
+}
+
+Long
+VisMF::FabBytesOnDisk (const VisMF::Header &hdr, int idx)
+{
+    if(hdr.m_vers == VisMF::Header::Compressed_v1) {
+        return hdr.m_fabBytes[idx];
+    }
+    return amrex::grow(hdr.m_ba[idx], hdr.m_ngrow).numPts() * hdr.m_ncomp
+           * hdr.m_writtenRD.numBytes();
+}
+
+void
+VisMF::DecompressFab (const char *src, const VisMF::Header &hdr, int idx, Real *dst)
+{
+    const Long npts(amrex::grow(hdr.m_ba[idx], hdr.m_ngrow).numPts());
+    Vector<CompBytes_t> compBytes(hdr.m_ncomp);
+    std::memcpy(compBytes.dataPtr(), src, hdr.m_ncomp * sizeof(CompBytes_t));
+    src += hdr.m_ncomp * sizeof(CompBytes_t);
+    for(int comp(0); comp < hdr.m_ncomp; ++comp) {
+        DecompressComponent(src, compBytes[comp], hdr.m_writtenRD, dst + comp * npts, npts);
+        src += compBytes[comp];
+    }
+}
+
 Long
 VisMF::Write (const FabArray<FArrayBox>&    mf,
               const std::string& mf_name,
@@ -978,12 +1139,28 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     bool oldHeader(currentVersion == VisMF::Header::Version_v1);
 
+    // ---- compress before writing so the writes in each set are not held up
+    const bool compressed(currentVersion == VisMF::Header::Compressed_v1);
+    Vector<Vector<char> > compressedFabs;
+    if(compressed) {
+        hdr.m_tolerance = compressionTolerance;
+        compressedFabs = CompressFabs(mf, compressionTolerance);
+    }
+
     if(useSparseFPP) {
         nfi.SetSparseFPP(procsWithDataVector);
     } else if(useDynamicSetSelection) {
         nfi.SetDynamic();
     }
     for( ; nfi.ReadyToWrite(); ++nfi) {
+        if(compressed) {
+            for(const auto &chunk : compressedFabs) {
+                nfi.Stream().write(chunk.dataPtr(), chunk.size());
+                bytesWritten += chunk.size();
+            }
+            nfi.Stream().flush();
+            continue;
+        }
         // ---- find the total number of bytes including fab headers if needed
         const FABio &fio = FArrayBox::getFABio();
         int whichRDBytes(whichRD->numBytes()), nFABs(0);
@@ -1101,6 +1278,15 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         hdr.CalculateMinMax(mf, coordinatorProc);
     }
 
+    if(compressed) {
+        hdr.m_fabBytes.assign(mf.size(), 0);
+        int ifab(0);
+        for(MFIter mfi(mf); mfi.isValid(); ++mfi, ++ifab) {
+            hdr.m_fabBytes[mfi.index()] = compressedFabs[ifab].size();
+        }
+        ParallelDescriptor::ReduceLongSum(hdr.m_fabBytes.dataPtr(), hdr.m_fabBytes.size());
+    }
+
     VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
                        ParallelDescriptor::Communicator());
 
@@ -1135,6 +1321,9 @@ VisMF::WriteOnlyHeader (const FabArray<FArrayBox> & mf,
         fod.m_name = "Not Saved";
         fod.m_head = -1;
     }
+    if(hdr.m_vers == VisMF::Header::Compressed_v1) {
+        hdr.m_fabBytes.assign(mf.size(), 0);
+    }
 
     // Write header on the IOProcessorNumber
     int coordinatorProc(ParallelDescriptor::IOProcessorNumber());
@@ -1160,8 +1349,9 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
       coordinatorProc = nfi.CoordinatorProc();
     }
 
-    if(FArrayBox::getFormat() == FABio::FAB_ASCII ||
-       FArrayBox::getFormat() == FABio::FAB_8BIT)
+    if((FArrayBox::getFormat() == FABio::FAB_ASCII ||
+        FArrayBox::getFormat() == FABio::FAB_8BIT) &&
+       hdr.m_vers != VisMF::Header::Compressed_v1)
     {
 
 #ifdef BL_USE_MPI
@@ -1291,8 +1481,12 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
               for(int i(0); i < index.size(); ++i) {
                  hdr.m_fod[index[i]].m_name = whichFileName;
                  hdr.m_fod[index[i]].m_head = currentOffset[whichFileNumber];
-                 currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
-                                                   + fabHeaderBytes[index[i]];
+                 if(hdr.m_vers == VisMF::Header::Compressed_v1) {
+                   currentOffset[whichFileNumber] += hdr.m_fabBytes[index[i]];
+                 } else {
+                   currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
+                                                     + fabHeaderBytes[index[i]];
+                 }
               }
             }
           }
@@ -1401,7 +1595,23 @@ VisMF::readFAB (int                  idx,
           fabdata = hostfab->dataPtr();
       }
 #endif
-      if(whichComp == -1) {    // ---- read all components
+      if(hdr.m_vers == Header::Compressed_v1) {
+        if(whichComp == -1) {    // ---- read all components
+          Vector<char> fabBytes(hdr.m_fabBytes[idx]);
+          infs->read(fabBytes.dataPtr(), fabBytes.size());
+          VisMF::DecompressFab(fabBytes.dataPtr(), hdr, idx, fabdata);
+        } else {                 // ---- read only the sizes and that component
+          Vector<CompBytes_t> compBytes(hdr.m_ncomp);
+          infs->read((char *) compBytes.dataPtr(), hdr.m_ncomp * sizeof(CompBytes_t));
+          infs->seekg(std::accumulate(compBytes.begin(), compBytes.begin() + whichComp,
+                                      CompBytes_t(0)), std::ios::cur);
+          Vector<char> compData(compBytes[whichComp]);
+          infs->read(compData.dataPtr(), compData.size());
+          DecompressComponent(compData.dataPtr(), compData.size(), hdr.m_writtenRD,
+                              fabdata, fab->box().numPts());
+        }
+
+      } else if(whichComp == -1) {    // ---- read all components
         if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
           infs->read((char *) fabdata, fab->nBytes());
         } else {
@@ -1459,7 +1669,11 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
           fabdata = hostfab->dataPtr();
       }
 #endif
-      if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
+      if(hdr.m_vers == Header::Compressed_v1) {
+        Vector<char> fabBytes(hdr.m_fabBytes[idx]);
+        infs->read(fabBytes.dataPtr(), fabBytes.size());
+        VisMF::DecompressFab(fabBytes.dataPtr(), hdr, idx, fabdata);
+      } else if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
         infs->read((char *) fabdata, fab.nBytes());
       } else {
         Long readDataItems(fab.box().numPts() * fab.nComp());
@@ -1480,6 +1694,265 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
 }
 
 
+#ifdef BL_USE_MPI
+Long
+VisMF::ReadAggregated (FabArray<FArrayBox> &mf,
+                       const std::string   &mf_name,
+                       const VisMF::Header &hdr)
+{
+    BL_PROFILE("VisMF::ReadAggregated()");
+
+    const int myProc(ParallelDescriptor::MyProc());
+    const int nProcs(ParallelDescriptor::NProcs());
+    const int nBoxes(hdr.m_ba.size());
+    const bool compressed(hdr.m_vers == Header::Compressed_v1);
+    const bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
+    const DistributionMapping& dm = mf.DistributionMap();
+
+    // ---- order the fabs the way they are on disk
+    Vector<int> fileOrder(nBoxes);
+    std::iota(fileOrder.begin(), fileOrder.end(), 0);
+    std::sort(fileOrder.begin(), fileOrder.end(), [&hdr] (int a, int b)
+              { return std::tie(hdr.m_fod[a].m_name, hdr.m_fod[a].m_head)
+                     < std::tie(hdr.m_fod[b].m_name, hdr.m_fod[b].m_head); });
+
+    Vector<Long> fabBytes(nBoxes);
+    Long totalBytes(0);
+    int nFiles(0);
+    for(int i(0); i < nBoxes; ++i) {
+      fabBytes[i] = VisMF::FabBytesOnDisk(hdr, i);
+      totalBytes += fabBytes[i];
+      if(i == 0 || hdr.m_fod[fileOrder[i]].m_name != hdr.m_fod[fileOrder[i-1]].m_name) {
+        ++nFiles;
+      }
+    }
+
+    int nreaders = (nReaders > 0) ? nReaders : nFiles * nMFFileInStreams;
+    nreaders = std::max(1, std::min(nreaders, nProcs));
+
+    // ---- split the bytes evenly among the readers and merge the fabs
+    // ---- that are contiguous on disk into chunks.  All ranks compute
+    // ---- the same chunks.
+    struct ReadChunk {
+        int reader;
+        int begin, end;  // ---- range in fileOrder
+        Long offset, nbytes;
+    };
+    Vector<ReadChunk> chunks;
+    Long bytesBefore(0);
+    for(int k(0); k < nBoxes; ++k) {
+      const int idx(fileOrder[k]);
+      const FabOnDisk &fod = hdr.m_fod[idx];
+      Long mid(bytesBefore + fabBytes[idx] / 2);
+      int reader = (totalBytes > 0) ? static_cast<int>((mid * nreaders) / totalBytes) : 0;
+      reader = std::min(reader, nreaders - 1);
+      reader = static_cast<int>((static_cast<Long>(reader) * nProcs) / nreaders);
+      bytesBefore += fabBytes[idx];
+
+      bool newChunk(chunks.empty());
+      if( ! newChunk) {
+        const ReadChunk &c = chunks.back();
+        const FabOnDisk &prev = hdr.m_fod[fileOrder[k-1]];
+        newChunk = c.reader != reader || prev.m_name != fod.m_name
+                || c.offset + c.nbytes != fod.m_head
+                || c.nbytes + fabBytes[idx] > readAggregateSize;
+      }
+      if(newChunk) {
+        chunks.push_back(ReadChunk{reader, k, k+1, fod.m_head, fabBytes[idx]});
+      } else {
+        chunks.back().end = k+1;
+        chunks.back().nbytes += fabBytes[idx];
+      }
+    }
+
+    const int seqNum(ParallelDescriptor::SeqNum());
+
+    auto copyToFab = [&] (int idx, char *src)
+    {
+        FArrayBox &fab = mf[idx];
+        Real* fabdata = fab.dataPtr();
+#ifdef AMREX_USE_GPU
+        std::unique_ptr<FArrayBox> hostfab;
+        if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+            hostfab = std::make_unique<FArrayBox>(fab.box(), fab.nComp(), The_Pinned_Arena());
+            fabdata = hostfab->dataPtr();
+        }
+#endif
+        if(compressed) {
+          VisMF::DecompressFab(src, hdr, idx, fabdata);
+        } else if(doConvert) {
+          RealDescriptor::convertToNativeFormat(fabdata, fab.box().numPts() * fab.nComp(),
+                                                src, hdr.m_writtenRD);
+        } else {
+          std::memcpy(fabdata, src, fab.nBytes());
+        }
+#ifdef AMREX_USE_GPU
+        if (hostfab) {
+            Gpu::htod_memcpy_async(fab.dataPtr(), hostfab->dataPtr(), fab.size()*sizeof(Real));
+            Gpu::streamSynchronize();
+        }
+#endif
+    };
+
+    // ---- post one receive per (chunk, owner) pair
+    Vector<int> recvChunk;
+    Vector<Vector<char> > recvBuf;
+    Vector<MPI_Request> recvReqs;
+    for(int ic(0); ic < chunks.size(); ++ic) {
+      const ReadChunk &c = chunks[ic];
+      if(c.reader == myProc) {
+        continue;
+      }
+      Long nbytes(0);
+      for(int k(c.begin); k < c.end; ++k) {
+        if(dm[fileOrder[k]] == myProc) {
+          nbytes += fabBytes[fileOrder[k]];
+        }
+      }
+      if(nbytes > 0) {
+        recvChunk.push_back(ic);
+        recvBuf.emplace_back(nbytes);
+        recvReqs.push_back(ParallelDescriptor::Arecv(recvBuf.back().dataPtr(), nbytes,
+                                                     c.reader, seqNum).req());
+      }
+    }
+
+    auto unpackRecv = [&] (int ir)
+    {
+        const ReadChunk &c = chunks[recvChunk[ir]];
+        char *src = recvBuf[ir].dataPtr();
+        for(int k(c.begin); k < c.end; ++k) {
+          const int idx(fileOrder[k]);
+          if(dm[idx] == myProc) {
+            copyToFab(idx, src);
+            src += fabBytes[idx];
+          }
+        }
+        Vector<char>().swap(recvBuf[ir]);
+    };
+
+    Vector<int> recvIndx(recvReqs.size());
+    Vector<MPI_Status> recvStats(recvReqs.size());
+    int nRecvDone(0);
+    auto unpackCompletedRecvs = [&] (bool wait)
+    {
+        if(nRecvDone == recvReqs.size()) {
+          return;
+        }
+        int ncompleted(0);
+        if(wait) {
+          ParallelDescriptor::Waitsome(recvReqs, ncompleted, recvIndx, recvStats);
+        } else {
+          BL_MPI_REQUIRE( MPI_Testsome(recvReqs.size(), recvReqs.dataPtr(), &ncompleted,
+                                       recvIndx.dataPtr(), recvStats.dataPtr()) );
+        }
+        for(int j(0); j < ncompleted; ++j) {
+          unpackRecv(recvIndx[j]);
+        }
+        nRecvDone += ncompleted;
+    };
+
+    // ---- read my chunks with the next read running in the background
+    Vector<int> myChunks;
+    for(int ic(0); ic < chunks.size(); ++ic) {
+      if(chunks[ic].reader == myProc) {
+        myChunks.push_back(ic);
+      }
+    }
+
+    Long bytesRead(0);
+    Vector<Vector<char> > sendBuf;
+    Vector<MPI_Request> sendReqs;
+
+    if( ! myChunks.empty()) {
+      std::ifstream ifs;
+      std::string openFileName;
+      auto readChunk = [&] (int ic, Vector<char> *buf) -> bool
+      {
+          const ReadChunk &c = chunks[ic];
+          std::string fullName(VisMF::DirName(mf_name) + hdr.m_fod[fileOrder[c.begin]].m_name);
+          if(fullName != openFileName) {
+            ifs.close();
+            ifs.clear();
+            ifs.open(fullName.c_str(), std::ios::in | std::ios::binary);
+            openFileName = fullName;
+          }
+          if( ! ifs.good()) {
+            return false;
+          }
+          buf->resize(c.nbytes);
+          ifs.seekg(c.offset, std::ios::beg);
+          ifs.read(buf->dataPtr(), c.nbytes);
+          return ifs.good();
+      };
+
+      Vector<char> readBuf[2];
+      std::future<bool> nextRead = std::async(std::launch::async, readChunk,
+                                              myChunks[0], &readBuf[0]);
+      for(int n(0); n < myChunks.size(); ++n) {
+        const int ic(myChunks[n]);
+        if( ! nextRead.get()) {
+          amrex::FileOpenFailed(openFileName);
+        }
+        Vector<char> &buf = readBuf[n%2];
+        if(n+1 < myChunks.size()) {
+          nextRead = std::async(std::launch::async, readChunk,
+                                myChunks[n+1], &readBuf[(n+1)%2]);
+        }
+        bytesRead += chunks[ic].nbytes;
+
+        // ---- convert my own fabs and pack the others, one message per owner
+        const ReadChunk &c = chunks[ic];
+        std::map<int, Vector<Long> > ownerOffsets;  // ---- [owner, offsets]
+        Long offset(0);
+        for(int k(c.begin); k < c.end; ++k) {
+          const int idx(fileOrder[k]);
+          if(dm[idx] == myProc) {
+            copyToFab(idx, buf.dataPtr() + offset);
+          } else {
+            ownerOffsets[dm[idx]].push_back(offset);
+          }
+          offset += fabBytes[idx];
+        }
+        for(auto &oo : ownerOffsets) {
+          Long nbytes(0);
+          for(int k(c.begin); k < c.end; ++k) {
+            if(dm[fileOrder[k]] == oo.first) {
+              nbytes += fabBytes[fileOrder[k]];
+            }
+          }
+          sendBuf.emplace_back(nbytes);
+          char *dst = sendBuf.back().dataPtr();
+          int j(0);
+          for(int k(c.begin); k < c.end; ++k) {
+            const int idx(fileOrder[k]);
+            if(dm[idx] == oo.first) {
+              std::memcpy(dst, buf.dataPtr() + oo.second[j++], fabBytes[idx]);
+              dst += fabBytes[idx];
+            }
+          }
+          sendReqs.push_back(ParallelDescriptor::Asend(sendBuf.back().dataPtr(), nbytes,
+                                                       oo.first, seqNum).req());
+        }
+
+        unpackCompletedRecvs(false);
+      }
+    }
+
+    while(nRecvDone < recvReqs.size()) {
+      unpackCompletedRecvs(true);
+    }
+
+    if( ! sendReqs.empty()) {
+      Vector<MPI_Status> sendStats(sendReqs.size());
+      ParallelDescriptor::Waitall(sendReqs, sendStats);
+    }
+
+    return bytesRead;
+}
+#endif
+
+
 void
 VisMF::Read (FabArray<FArrayBox> &mf,
              const std::string   &mf_name,
@@ -1545,7 +2018,26 @@ VisMF::Read (FabArray<FArrayBox> &mf,
   int nProcs(ParallelDescriptor::NProcs());
   bool noFabHeader(NoFabHeader(hdr));
 
-  if(noFabHeader && useSynchronousReads) {
+  if(noFabHeader && useAggregatedReads &&
+     mf.nComp() == hdr.m_ncomp && mf.nGrowVect() == hdr.m_ngrow)
+  {
+
+    double aggStartTime(amrex::second());
+    Long bytesRead = VisMF::ReadAggregated(mf, mf_name, hdr);
+    if(verbose) {
+      double aggTime = amrex::second() - aggStartTime;
+      ParallelDescriptor::ReduceLongSum(bytesRead, coordinatorProc);
+      ParallelDescriptor::ReduceRealMax(aggTime, coordinatorProc);
+      if(myProc == coordinatorProc) {
+        const double gb = static_cast<double>(bytesRead) / (1024.0*1024.0*1024.0);
+        amrex::AllPrint() << "FARead ::  aggregated read of " << gb << " GB in "
+                          << aggTime << " s = " << (aggTime > 0.0 ? gb/aggTime : 0.0)
+                          << " GB/s" << std::endl;
+      }
+    }
+
+  } else if(noFabHeader && useSynchronousReads &&
+            hdr.m_vers != VisMF::Header::Compressed_v1) {
 
     // ---- This code is only for reading in file order
     bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
@@ -2122,7 +2614,8 @@ VisMF::clear ()
 bool VisMF::NoFabHeader(const VisMF::Header &hdr) {
   if(hdr.m_vers == VisMF::Header::NoFabHeader_v1       ||
     hdr.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+    hdr.m_vers == VisMF::Header::Compressed_v1)
   {
     return true;
   }
@@ -1,10 +1,12 @@
 #include <AMReX.H>
 #include <AMReX_Parser_Y.H>
+#include <AMReX_Parser_Exe.H>
 #include <amrex_parser.tab.h>
 
 #include <algorithm>
 #include <cstdarg>
 #include <string>
+#include <utility>
 
 void
 amrex_parsererror (char const *s, ...)
@@ -20,6 +22,7 @@ amrex_parsererror (char const *s, ...)
 namespace amrex {
 
 static struct parser_node* parser_root = nullptr;
+static bool parser_cse = true;
 
 // This is called by a bison rule to store the original AST in a static variable.
 void
@@ -123,16 +126,277 @@ parser_newlist (struct parser_node* nl, struct parser_node* nr)
 
 /*******************************************************************/
 
-struct amrex_parser*
-amrex_parser_new ()
+/* Common subexpression elimination.  This works on the original AST
+ * allocated with std::malloc, before it is moved into the memory pool
+ * of amrex_parser.  Repeated subexpressions are computed once into
+ * local variables, exactly as if the user had written "t = ...; ..."
+ * in the expression.
+ */
+
+static void
+parser_ast_free (struct parser_node* node)
+{
+    switch (node->type)
+    {
+    case PARSER_NUMBER:
+        break;
+    case PARSER_SYMBOL:
+        std::free(((struct parser_symbol*)node)->name);
+        break;
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+    case PARSER_LIST:
+        parser_ast_free(node->l);
+        parser_ast_free(node->r);
+        break;
+    case PARSER_NEG:
+        parser_ast_free(node->l);
+        break;
+    case PARSER_F1:
+        parser_ast_free(((struct parser_f1*)node)->l);
+        break;
+    case PARSER_F2:
+        parser_ast_free(((struct parser_f2*)node)->l);
+        parser_ast_free(((struct parser_f2*)node)->r);
+        break;
+    case PARSER_F3:
+        parser_ast_free(((struct parser_f3*)node)->n1);
+        parser_ast_free(((struct parser_f3*)node)->n2);
+        parser_ast_free(((struct parser_f3*)node)->n3);
+        break;
+    case PARSER_ASSIGN:
+        parser_ast_free((struct parser_node*)(((struct parser_assign*)node)->s));
+        parser_ast_free(((struct parser_assign*)node)->v);
+        break;
+    default:
+        amrex::Abort("parser_ast_free: unknown node type " + std::to_string(node->type));
+    }
+    std::free((void*)node);
+}
+
+static bool
+parser_ast_equal (struct parser_node* a, struct parser_node* b)
+{
+    if (a->type != b->type) { return false; }
+    switch (a->type)
+    {
+    case PARSER_NUMBER:
+    {
+        double va = ((struct parser_number*)a)->value;
+        double vb = ((struct parser_number*)b)->value;
+        return va == vb && std::signbit(va) == std::signbit(vb);
+    }
+    case PARSER_SYMBOL:
+        return std::strcmp(((struct parser_symbol*)a)->name,
+                           ((struct parser_symbol*)b)->name) == 0;
+    case PARSER_ADD:
+    case PARSER_MUL: // commutative
+        return (parser_ast_equal(a->l, b->l) && parser_ast_equal(a->r, b->r))
+            || (parser_ast_equal(a->l, b->r) && parser_ast_equal(a->r, b->l));
+    case PARSER_SUB:
+    case PARSER_DIV:
+        return parser_ast_equal(a->l, b->l) && parser_ast_equal(a->r, b->r);
+    case PARSER_NEG:
+        return parser_ast_equal(a->l, b->l);
+    case PARSER_F1:
+        return ((struct parser_f1*)a)->ftype == ((struct parser_f1*)b)->ftype
+            && parser_ast_equal(((struct parser_f1*)a)->l, ((struct parser_f1*)b)->l);
+    case PARSER_F2:
+        return ((struct parser_f2*)a)->ftype == ((struct parser_f2*)b)->ftype
+            && parser_ast_equal(((struct parser_f2*)a)->l, ((struct parser_f2*)b)->l)
+            && parser_ast_equal(((struct parser_f2*)a)->r, ((struct parser_f2*)b)->r);
+    case PARSER_F3:
+        return ((struct parser_f3*)a)->ftype == ((struct parser_f3*)b)->ftype
+            && parser_ast_equal(((struct parser_f3*)a)->n1, ((struct parser_f3*)b)->n1)
+            && parser_ast_equal(((struct parser_f3*)a)->n2, ((struct parser_f3*)b)->n2)
+            && parser_ast_equal(((struct parser_f3*)a)->n3, ((struct parser_f3*)b)->n3);
+    default:
+        return false;
+    }
+}
+
+namespace {
+    struct ParserCSECandidate {
+        struct parser_node** slot;
+        int cost;
+        bool conditional; // inside a branch of if()
+    };
+}
+
+/* Collects the subexpressions that are worth replacing.  Returns the
+ * estimated cost of evaluating the node, or -1 if it depends on a
+ * variable assigned in the expression, in which case it cannot be
+ * moved to the beginning of the expression.
+ */
+static int
+parser_cse_collect (struct parser_node** slot, bool conditional,
+                    std::set<std::string> const& local_symbols,
+                    Vector<ParserCSECandidate>& candidates)
+{
+    struct parser_node* node = *slot;
+    int cost = 0;
+    switch (node->type)
+    {
+    case PARSER_NUMBER:
+        return 0;
+    case PARSER_SYMBOL:
+        return local_symbols.count(((struct parser_symbol*)node)->name) ? -1 : 0;
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+    {
+        int cl = parser_cse_collect(&(node->l), conditional, local_symbols, candidates);
+        int cr = parser_cse_collect(&(node->r), conditional, local_symbols, candidates);
+        cost = (cl < 0 || cr < 0) ? -1 : cl + cr + 1;
+        break;
+    }
+    case PARSER_NEG:
+    {
+        int cl = parser_cse_collect(&(node->l), conditional, local_symbols, candidates);
+        cost = (cl < 0) ? -1 : cl + 1;
+        break;
+    }
+    case PARSER_F1:
+    {
+        int cl = parser_cse_collect(&(((struct parser_f1*)node)->l), conditional,
+                                    local_symbols, candidates);
+        cost = (cl < 0) ? -1 : cl + 8;
+        break;
+    }
+    case PARSER_F2:
+    {
+        int cl = parser_cse_collect(&(((struct parser_f2*)node)->l), conditional,
+                                    local_symbols, candidates);
+        int cr = parser_cse_collect(&(((struct parser_f2*)node)->r), conditional,
+                                    local_symbols, candidates);
+        cost = (cl < 0 || cr < 0) ? -1 : cl + cr + 8;
+        break;
+    }
+    case PARSER_F3:
+    {
+        // Only the condition is always evaluated.
+        int c1 = parser_cse_collect(&(((struct parser_f3*)node)->n1), conditional,
+                                    local_symbols, candidates);
+        int c2 = parser_cse_collect(&(((struct parser_f3*)node)->n2), true,
+                                    local_symbols, candidates);
+        int c3 = parser_cse_collect(&(((struct parser_f3*)node)->n3), true,
+                                    local_symbols, candidates);
+        cost = (c1 < 0 || c2 < 0 || c3 < 0) ? -1 : c1 + std::max(c2,c3) + 1;
+        break;
+    }
+    case PARSER_ASSIGN:
+        parser_cse_collect(&(((struct parser_assign*)node)->v), conditional,
+                           local_symbols, candidates);
+        return -1;
+    case PARSER_LIST:
+        parser_cse_collect(&(node->l), conditional, local_symbols, candidates);
+        parser_cse_collect(&(node->r), conditional, local_symbols, candidates);
+        return -1;
+    default:
+        amrex::Abort("parser_cse_collect: unknown node type " + std::to_string(node->type));
+    }
+    // A single arithmetic operation on two leaves is not worth a local variable.
+    if (cost >= 2) {
+        candidates.push_back(ParserCSECandidate{slot, cost, conditional});
+    }
+    return cost;
+}
+
+static struct parser_node*
+parser_ast_cse (struct parser_node* root)
+{
+    std::set<std::string> symbols, local_symbols;
+    parser_ast_get_symbols(root, symbols, local_symbols);
+
+    Vector<std::pair<std::string,struct parser_node*>> temps;
+    while (static_cast<int>(temps.size()) < AMREX_PARSER_STACK_SIZE/2)
+    {
+        Vector<ParserCSECandidate> candidates;
+        parser_cse_collect(&root, false, local_symbols, candidates);
+        for (auto& t : temps) {
+            parser_cse_collect(&(t.second), false, local_symbols, candidates);
+        }
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [] (ParserCSECandidate const& a, ParserCSECandidate const& b)
+                         { return a.cost > b.cost; });
+
+        // Find the most expensive subexpression that appears more than
+        // once and is evaluated unconditionally at least once, so that
+        // computing it up front never evaluates something that the
+        // original expression would not.
+        bool found = false;
+        for (int i = 0; i < candidates.size() && !found; ++i) {
+            Vector<int> same{i};
+            bool always = !candidates[i].conditional;
+            for (int j = i+1; j < candidates.size() && candidates[j].cost == candidates[i].cost; ++j) {
+                if (parser_ast_equal(*(candidates[i].slot), *(candidates[j].slot))) {
+                    same.push_back(j);
+                    always = always || !candidates[j].conditional;
+                }
+            }
+            if (same.size() > 1 && always) {
+                std::string name = "__amrex_cse" + std::to_string(temps.size());
+                while (symbols.count(name)) { name += "_"; }
+                struct parser_node* value = *(candidates[i].slot);
+                for (int j : same) {
+                    if (j != i) { parser_ast_free(*(candidates[j].slot)); }
+                    *(candidates[j].slot) = parser_newsymbol(parser_makesymbol(&name[0]));
+                }
+                temps.emplace_back(name, value);
+                found = true;
+            }
+        }
+        if (!found) { break; }
+    }
+
+    // A temporary may use temporaries found after it.  Emit them in an
+    // order such that every temporary is defined before it is used.
+    Vector<int> order;
+    Vector<char> emitted(temps.size(), 0);
+    while (order.size() < temps.size()) {
+        for (int i = 0; i < temps.size(); ++i) {
+            if (emitted[i]) { continue; }
+            std::set<std::string> used, unused;
+            parser_ast_get_symbols(temps[i].second, used, unused);
+            bool ready = true;
+            for (int j = 0; j < temps.size(); ++j) {
+                if (!emitted[j] && j != i && used.count(temps[j].first)) { ready = false; }
+            }
+            if (ready) {
+                order.push_back(i);
+                emitted[i] = 1;
+            }
+        }
+    }
+
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        auto& t = temps[*it];
+        root = parser_newlist(parser_newassign(parser_makesymbol(&t.first[0]), t.second), root);
+    }
+    return root;
+}
+
+void
+parser_set_cse (bool enable)
+{
+    parser_cse = enable;
+}
+
+/*******************************************************************/
+
+static struct amrex_parser*
+parser_new_from_ast (struct parser_node* root, int move)
 {
     auto my_parser = (struct amrex_parser*) std::malloc(sizeof(struct amrex_parser));
 
-    my_parser->sz_mempool = parser_ast_size(parser_root);
+    my_parser->sz_mempool = parser_ast_size(root);
     my_parser->p_root = std::malloc(my_parser->sz_mempool);
     my_parser->p_free = my_parser->p_root;
 
-    my_parser->ast = parser_ast_dup(my_parser, parser_root, 1); /* 1: free the source parser_root */
+    my_parser->ast = parser_ast_dup(my_parser, root, move);
 
     if ((char*)my_parser->p_root + my_parser->sz_mempool != (char*)my_parser->p_free) {
         amrex::Abort("amrex_parser_new: error in memory size");
@@ -143,6 +407,34 @@ amrex_parser_new ()
     return my_parser;
 }
 
+struct amrex_parser*
+amrex_parser_new ()
+{
+    if (!parser_cse) {
+        return parser_new_from_ast(parser_root, 1); /* 1: free the source parser_root */
+    }
+
+    struct amrex_parser* plain = parser_new_from_ast(parser_root, 0);
+    struct parser_node* root = parser_ast_cse(parser_root);
+    if (root == parser_root) { // nothing found
+        parser_ast_free(root);
+        return plain;
+    }
+
+    // The temporaries live on the stack.  Fall back to the original
+    // expression if they do not fit.
+    struct amrex_parser* cse = parser_new_from_ast(root, 1);
+    int max_stack_size = 0, stack_size = 0;
+    parser_exe_size(cse, max_stack_size, stack_size);
+    if (max_stack_size <= AMREX_PARSER_STACK_SIZE) {
+        amrex_parser_delete(plain);
+        return cse;
+    } else {
+        amrex_parser_delete(cse);
+        return plain;
+    }
+}
+
 void
 amrex_parser_delete (struct amrex_parser* parser)
 {
@@ -371,6 +663,73 @@ parser_ast_dup (struct amrex_parser* my_parser, struct parser_node* node, int mo
     node->lvp.v = -node->l->lvp.v; \
     node->rip = node->l->rip;
 
+static int
+parser_ast_count_assign (struct parser_node* node, char const* name)
+{
+    switch (node->type)
+    {
+    case PARSER_NUMBER:
+    case PARSER_SYMBOL:
+        return 0;
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+    case PARSER_LIST:
+    case PARSER_ADD_PP:
+    case PARSER_SUB_PP:
+    case PARSER_MUL_PP:
+    case PARSER_DIV_PP:
+        return parser_ast_count_assign(node->l, name) + parser_ast_count_assign(node->r, name);
+    case PARSER_NEG:
+    case PARSER_NEG_P:
+        return parser_ast_count_assign(node->l, name);
+    case PARSER_F1:
+        return parser_ast_count_assign(((struct parser_f1*)node)->l, name);
+    case PARSER_F2:
+        return parser_ast_count_assign(((struct parser_f2*)node)->l, name)
+            +  parser_ast_count_assign(((struct parser_f2*)node)->r, name);
+    case PARSER_F3:
+        return parser_ast_count_assign(((struct parser_f3*)node)->n1, name)
+            +  parser_ast_count_assign(((struct parser_f3*)node)->n2, name)
+            +  parser_ast_count_assign(((struct parser_f3*)node)->n3, name);
+    case PARSER_ASSIGN:
+        return int(std::strcmp(((struct parser_assign*)node)->s->name, name) == 0)
+            + parser_ast_count_assign(((struct parser_assign*)node)->v, name);
+    case PARSER_ADD_VP:
+    case PARSER_SUB_VP:
+    case PARSER_MUL_VP:
+    case PARSER_DIV_VP:
+        return parser_ast_count_assign(node->r, name);
+    default:
+        amrex::Abort("parser_ast_count_assign: unknown node type " + std::to_string(node->type));
+        return 0;
+    }
+}
+
+/* Local variables that are assigned a constant, e.g., "a = 2*pi; ...", or
+ * that became constant after setConstant, are replaced by their values in
+ * the rest of the expression so that they can be folded further.  Variables
+ * that are assigned more than once are left alone.
+ */
+static void
+parser_ast_propagate_constants (struct parser_node* node, struct parser_node* all_assigns,
+                                struct parser_node* rest)
+{
+    if (node->type == PARSER_LIST) {
+        parser_ast_propagate_constants(node->l, all_assigns, rest);
+        parser_ast_propagate_constants(node->r, all_assigns, rest);
+    } else if (node->type == PARSER_ASSIGN) {
+        auto asgn = (struct parser_assign*)node;
+        if (asgn->v->type == PARSER_NUMBER &&
+            parser_ast_count_assign(all_assigns, asgn->s->name) == 1 &&
+            parser_ast_count_assign(rest, asgn->s->name) == 0)
+        {
+            parser_ast_setconst(rest, asgn->s->name, ((struct parser_number*)(asgn->v))->value);
+        }
+    }
+}
+
 void
 parser_ast_optimize (struct parser_node* node)
 {
@@ -1171,6 +1530,7 @@ parser_ast_optimize (struct parser_node* node)
         break;
     case PARSER_LIST:
         parser_ast_optimize(node->l);
+        parser_ast_propagate_constants(node->l, node->l, node->r);
         parser_ast_optimize(node->r);
         break;
     default:
@@ -66,6 +66,7 @@ MultiMask::define (const BoxArray& regba, const DistributionMapping& dm, const G
                                                    regmf,
                                                    IntVect::TheZeroVector(),
                                                    geom.periodicity());
+        FabArrayBase::CommCachePin cpc_pin(cpc);
         m_fa.setVal(bndrydata_covered, cpc, 0, 1);
     }
 }
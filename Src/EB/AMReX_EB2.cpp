@@ -23,6 +23,7 @@ AMREX_EXPORT Vector<std::unique_ptr<IndexSpace> > IndexSpace::m_instance;
 AMREX_EXPORT int max_grid_size = 64;
 AMREX_EXPORT bool extend_domain_face = true;
 AMREX_EXPORT int num_coarsen_opt = 0;
+AMREX_EXPORT bool build_lazily = false;
 
 void Initialize ()
 {
@@ -30,6 +31,7 @@ void Initialize ()
     pp.queryAdd("max_grid_size", max_grid_size);
     pp.queryAdd("extend_domain_face", extend_domain_face);
     pp.queryAdd("num_coarsen_opt", num_coarsen_opt);
+    pp.queryAdd("lazy", build_lazily);
 
     amrex::ExecOnFinalize(Finalize);
 }
@@ -49,6 +51,11 @@ int NumCoarsenOpt ()
     return num_coarsen_opt;
 }
 
+bool BuildLazily ()
+{
+    return build_lazily;
+}
+
 void
 IndexSpace::push (IndexSpace* ispace)
 {
@@ -3,6 +3,7 @@
 #include <AMReX_IArrayBox.H>
 #include <AMReX_EB_chkpt_file.H>
 #include <algorithm>
+#include <map>
 
 namespace amrex { namespace EB2 {
 
@@ -80,6 +81,83 @@ Level::prepareForCoarsening (const Level& rhs, int max_grid_size, IntVect ngrow)
     m_ok = true;
 }
 
+void
+Level::merge (const Level& rhs, const BoxArray& region)
+{
+    const Box& domain = m_geom.Domain();
+    auto in_region = [&] (Box const& b) { return region.intersects(b & domain); };
+
+    if (!rhs.m_covered_grids.empty()) {
+        BoxList bl = m_covered_grids.boxList();
+        for (int i = 0, N = rhs.m_covered_grids.size(); i < N; ++i) {
+            const Box& b = rhs.m_covered_grids[i];
+            if (in_region(b)) { bl.push_back(b); }
+        }
+        if (!bl.isEmpty()) { m_covered_grids = BoxArray(std::move(bl)); }
+    }
+
+    m_ok = true;
+
+    // The new grids are ours followed by those of rhs, on the same processes.
+    const int nold = m_grids.size();
+    BoxList bl = m_grids.boxList();
+    Vector<int> pmap = m_dmap.ProcessorMap();
+    Vector<int> rhs_index;
+    for (int i = 0, N = rhs.m_grids.size(); i < N; ++i) {
+        if (in_region(rhs.m_grids[i])) {
+            bl.push_back(rhs.m_grids[i]);
+            pmap.push_back(rhs.m_dmap[i]);
+            rhs_index.push_back(i);
+        }
+    }
+
+    if (rhs_index.empty()) {
+        m_allregular = m_grids.empty() && m_covered_grids.empty();
+        return;
+    }
+
+    BoxArray grids(std::move(bl));
+    DistributionMapping dmap(std::move(pmap));
+
+    MFInfo mf_info;
+    mf_info.SetTag("EB2::Level");
+    auto merge_data = [&] (auto& mf, auto const& rhsmf)
+    {
+        const int ncomp = rhsmf.nComp();
+        const IntVect ng = rhsmf.nGrowVect();
+        std::decay_t<decltype(mf)> tmp(amrex::convert(grids, rhsmf.ixType()), dmap,
+                                       ncomp, ng, mf_info);
+        for (MFIter mfi(tmp); mfi.isValid(); ++mfi) {
+            const int i = mfi.index();
+            if (i < nold) {
+                tmp[mfi].template copy<RunOn::Device>(mf[i]);
+            } else {
+                tmp[mfi].template copy<RunOn::Device>(rhsmf[rhs_index[i-nold]]);
+            }
+        }
+        mf = std::move(tmp);
+    };
+
+    merge_data(m_levelset, rhs.m_levelset);
+    merge_data(m_cellflag, rhs.m_cellflag);
+    merge_data(m_volfrac, rhs.m_volfrac);
+    merge_data(m_centroid, rhs.m_centroid);
+    merge_data(m_bndryarea, rhs.m_bndryarea);
+    merge_data(m_bndrycent, rhs.m_bndrycent);
+    merge_data(m_bndrynorm, rhs.m_bndrynorm);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        merge_data(m_areafrac[idim], rhs.m_areafrac[idim]);
+        merge_data(m_facecent[idim], rhs.m_facecent[idim]);
+        merge_data(m_edgecent[idim], rhs.m_edgecent[idim]);
+    }
+
+    // m_levelset no longer aliases the data in m_mgf.
+    m_mgf = MultiGFab();
+    m_grids = std::move(grids);
+    m_dmap = std::move(dmap);
+    m_allregular = false;
+}
+
 int
 Level::coarsenFromFine (Level& fineLevel, bool fill_boundary)
 {
@@ -90,6 +168,13 @@ Level::coarsenFromFine (Level& fineLevel, bool fill_boundary)
     m_covered_grids = amrex::coarsen(fine_covered_grids, 2);
     m_dmap = fine_dmap;
 
+    if (fine_grids.empty()) {
+        // Only possible for the part of a level built by a lazy index space
+        m_allregular = fine_covered_grids.empty();
+        m_ok = true;
+        return 0;
+    }
+
     if (! (fine_grids.coarsenable(2,2) &&
            (fine_covered_grids.empty() || fine_covered_grids.coarsenable(2,2)))) {
         return 1;
@@ -882,6 +967,112 @@ Level::fillEdgeCent (Array<MultiFab*,AMREX_SPACEDIM> const& a_edgecent, const Ge
     }
 }
 
+namespace {
+    // Fill the sparse data through dense temporaries holding at most one
+    // box per process at a time.  In round r, every process fills its r-th
+    // box, so that the dense fill functions, which communicate, are called
+    // by all processes with the same BoxArray.
+    template <std::size_t N, typename F>
+    void fillSparseByBox (Array<MultiSparseCutFab*,N> const& sparse,
+                          Vector<Real> const& defaults, F const& densefill)
+    {
+        const BoxArray& ba0 = sparse[0]->boxArray();
+        const DistributionMapping& dm = sparse[0]->DistributionMap();
+
+        Vector<Vector<int>> rounds;
+        {
+            std::map<int,int> nboxes;
+            for (int K = 0, N0 = static_cast<int>(ba0.size()); K < N0; ++K) {
+                const int r = nboxes[dm[K]]++;
+                if (r == static_cast<int>(rounds.size())) { rounds.emplace_back(); }
+                rounds[r].push_back(K);
+            }
+        }
+
+        for (auto const& ids : rounds)
+        {
+            Vector<int> pmap;
+            pmap.reserve(ids.size());
+            for (int K : ids) { pmap.push_back(dm[K]); }
+            DistributionMapping rdm(std::move(pmap));
+
+            Array<MultiFab,N> tmp;
+            for (std::size_t n = 0; n < N; ++n) {
+                const BoxArray& ba = sparse[n]->boxArray();
+                BoxList bl(ba.ixType());
+                bl.reserve(ids.size());
+                for (int K : ids) { bl.push_back(ba[K]); }
+                tmp[n].define(BoxArray(std::move(bl)), rdm,
+                              sparse[n]->nComp(), sparse[n]->nGrow());
+            }
+
+            densefill(tmp);
+
+            for (MFIter mfi(tmp[0], MFItInfo().DisableDeviceSync()); mfi.isValid(); ++mfi) {
+                const int K = ids[mfi.index()];
+                for (std::size_t n = 0; n < N; ++n) {
+                    sparse[n]->pack(K, tmp[n][mfi], defaults);
+                }
+            }
+        }
+    }
+}
+
+void
+Level::fillCentroid (MultiSparseCutFab& centroid, const Geometry& geom) const
+{
+    fillSparseByBox(Array<MultiSparseCutFab*,1>{&centroid}, {0.0},
+                    [&] (Array<MultiFab,1>& tmp) { fillCentroid(tmp[0], geom); });
+}
+
+void
+Level::fillBndryArea (MultiSparseCutFab& bndryarea, const Geometry& geom) const
+{
+    fillSparseByBox(Array<MultiSparseCutFab*,1>{&bndryarea}, {0.0},
+                    [&] (Array<MultiFab,1>& tmp) { fillBndryArea(tmp[0], geom); });
+}
+
+void
+Level::fillBndryCent (MultiSparseCutFab& bndrycent, const Geometry& geom) const
+{
+    fillSparseByBox(Array<MultiSparseCutFab*,1>{&bndrycent}, {-1.0},
+                    [&] (Array<MultiFab,1>& tmp) { fillBndryCent(tmp[0], geom); });
+}
+
+void
+Level::fillBndryNorm (MultiSparseCutFab& bndrynorm, const Geometry& geom) const
+{
+    fillSparseByBox(Array<MultiSparseCutFab*,1>{&bndrynorm}, {0.0},
+                    [&] (Array<MultiFab,1>& tmp) { fillBndryNorm(tmp[0], geom); });
+}
+
+void
+Level::fillAreaFrac (Array<MultiSparseCutFab*,AMREX_SPACEDIM> const& a_areafrac,
+                     const Geometry& geom) const
+{
+    fillSparseByBox(a_areafrac, {1.0, 0.0},
+                    [&] (Array<MultiFab,AMREX_SPACEDIM>& tmp)
+                    { fillAreaFrac(GetArrOfPtrs(tmp), geom); });
+}
+
+void
+Level::fillFaceCent (Array<MultiSparseCutFab*,AMREX_SPACEDIM> const& a_facecent,
+                     const Geometry& geom) const
+{
+    fillSparseByBox(a_facecent, {0.0},
+                    [&] (Array<MultiFab,AMREX_SPACEDIM>& tmp)
+                    { fillFaceCent(GetArrOfPtrs(tmp), geom); });
+}
+
+void
+Level::fillEdgeCent (Array<MultiSparseCutFab*,AMREX_SPACEDIM> const& a_edgecent,
+                     const Geometry& geom) const
+{
+    fillSparseByBox(a_edgecent, {1.0, -1.0},
+                    [&] (Array<MultiFab,AMREX_SPACEDIM>& tmp)
+                    { fillEdgeCent(GetArrOfPtrs(tmp), geom); });
+}
+
 void
 Level::fillLevelSet (MultiFab& levelset, const Geometry& geom) const
 {
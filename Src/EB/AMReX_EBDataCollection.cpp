@@ -2,18 +2,32 @@
 #include <AMReX_EBDataCollection.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_MultiCutFab.H>
+#include <AMReX_MultiSparseCutFab.H>
 
 #include <AMReX_EB2_Level.H>
 
 namespace amrex {
 
+namespace {
+    MultiCutFab* makeDenseCutFab (MultiSparseCutFab const* sparse,
+                                  FabArray<EBCellFlagFab> const& cellflags)
+    {
+        auto* r = new MultiCutFab(sparse->boxArray(), sparse->DistributionMap(),
+                                  sparse->nComp(), sparse->nGrow(), cellflags);
+        sparse->unpack(*r);
+        return r;
+    }
+}
+
 EBDataCollection::EBDataCollection (const EB2::Level& a_level,
                                     const Geometry& a_geom,
                                     const BoxArray& a_ba_in,
                                     const DistributionMapping& a_dm,
-                                    const Vector<int>& a_ngrow, EBSupport a_support)
+                                    const Vector<int>& a_ngrow, EBSupport a_support,
+                                    EBCutStorage a_storage)
     : m_ngrow(a_ngrow),
       m_support(a_support),
+      m_storage(a_storage),
       m_geom(a_geom)
 {
     // The BoxArray argument may not be cell-centered BoxArray.
@@ -34,11 +48,44 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
         m_volfrac = new MultiFab(a_ba, a_dm, 1, m_ngrow[1], MFInfo(), FArrayBoxFactory());
         a_level.fillVolFrac(*m_volfrac, m_geom);
 
-        m_centroid = new MultiCutFab(a_ba, a_dm, AMREX_SPACEDIM, m_ngrow[1], *m_cellflags);
-        a_level.fillCentroid(*m_centroid, m_geom);
+        if (m_storage == EBCutStorage::sparse) {
+            m_sparse_centroid = new MultiSparseCutFab(a_ba, a_dm, AMREX_SPACEDIM, m_ngrow[1],
+                                                      *m_cellflags);
+            a_level.fillCentroid(*m_sparse_centroid, m_geom);
+        } else {
+            m_centroid = new MultiCutFab(a_ba, a_dm, AMREX_SPACEDIM, m_ngrow[1], *m_cellflags);
+            a_level.fillCentroid(*m_centroid, m_geom);
+        }
     }
 
-    if (m_support == EBSupport::full)
+    if (m_support == EBSupport::full && m_storage == EBCutStorage::sparse)
+    {
+        const int ng = m_ngrow[2];
+
+        m_sparse_bndrycent = new MultiSparseCutFab(a_ba, a_dm, AMREX_SPACEDIM, ng, *m_cellflags);
+        a_level.fillBndryCent(*m_sparse_bndrycent, m_geom);
+
+        m_sparse_bndryarea = new MultiSparseCutFab(a_ba, a_dm, 1, ng, *m_cellflags);
+        a_level.fillBndryArea(*m_sparse_bndryarea, m_geom);
+
+        m_sparse_bndrynorm = new MultiSparseCutFab(a_ba, a_dm, AMREX_SPACEDIM, ng, *m_cellflags);
+        a_level.fillBndryNorm(*m_sparse_bndrynorm, m_geom);
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const BoxArray& faceba = amrex::convert(a_ba, IntVect::TheDimensionVector(idim));
+            m_sparse_areafrac[idim] = new MultiSparseCutFab(faceba, a_dm, 1, ng, *m_cellflags);
+            m_sparse_facecent[idim] = new MultiSparseCutFab(faceba, a_dm, AMREX_SPACEDIM-1, ng,
+                                                            *m_cellflags);
+            IntVect edge_type{1}; edge_type[idim] = 0;
+            m_sparse_edgecent[idim] = new MultiSparseCutFab(amrex::convert(a_ba, edge_type), a_dm,
+                                                            1, ng, *m_cellflags);
+        }
+
+        a_level.fillAreaFrac(m_sparse_areafrac, m_geom);
+        a_level.fillFaceCent(m_sparse_facecent, m_geom);
+        a_level.fillEdgeCent(m_sparse_edgecent, m_geom);
+    }
+    else if (m_support == EBSupport::full)
     {
         const int ng = m_ngrow[2];
 
@@ -80,6 +127,15 @@ EBDataCollection::~EBDataCollection ()
         delete m_facecent[idim];
         delete m_edgecent[idim];
     }
+    delete m_sparse_centroid;
+    delete m_sparse_bndrycent;
+    delete m_sparse_bndrynorm;
+    delete m_sparse_bndryarea;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        delete m_sparse_areafrac[idim];
+        delete m_sparse_facecent[idim];
+        delete m_sparse_edgecent[idim];
+    }
 }
 
 const FabArray<EBCellFlagFab>&
@@ -106,6 +162,11 @@ EBDataCollection::getVolFrac () const
 const MultiCutFab&
 EBDataCollection::getCentroid () const
 {
+    if (m_sparse_centroid != nullptr) {
+        std::call_once(m_centroid_once, [&] () {
+            m_centroid = makeDenseCutFab(m_sparse_centroid, *m_cellflags);
+        });
+    }
     AMREX_ASSERT(m_centroid != nullptr);
     return *m_centroid;
 }
@@ -113,6 +174,11 @@ EBDataCollection::getCentroid () const
 const MultiCutFab&
 EBDataCollection::getBndryCent () const
 {
+    if (m_sparse_bndrycent != nullptr) {
+        std::call_once(m_bndrycent_once, [&] () {
+            m_bndrycent = makeDenseCutFab(m_sparse_bndrycent, *m_cellflags);
+        });
+    }
     AMREX_ASSERT(m_bndrycent != nullptr);
     return *m_bndrycent;
 }
@@ -120,6 +186,11 @@ EBDataCollection::getBndryCent () const
 const MultiCutFab&
 EBDataCollection::getBndryArea () const
 {
+    if (m_sparse_bndryarea != nullptr) {
+        std::call_once(m_bndryarea_once, [&] () {
+            m_bndryarea = makeDenseCutFab(m_sparse_bndryarea, *m_cellflags);
+        });
+    }
     AMREX_ASSERT(m_bndryarea != nullptr);
     return *m_bndryarea;
 }
@@ -127,6 +198,13 @@ EBDataCollection::getBndryArea () const
 Array<const MultiCutFab*, AMREX_SPACEDIM>
 EBDataCollection::getAreaFrac () const
 {
+    if (m_sparse_areafrac[0] != nullptr) {
+        std::call_once(m_areafrac_once, [&] () {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                m_areafrac[idim] = makeDenseCutFab(m_sparse_areafrac[idim], *m_cellflags);
+            }
+        });
+    }
     AMREX_ASSERT(m_areafrac[0] != nullptr);
     return {AMREX_D_DECL(m_areafrac[0], m_areafrac[1], m_areafrac[2])};
 }
@@ -134,6 +212,13 @@ EBDataCollection::getAreaFrac () const
 Array<const MultiCutFab*, AMREX_SPACEDIM>
 EBDataCollection::getFaceCent () const
 {
+    if (m_sparse_facecent[0] != nullptr) {
+        std::call_once(m_facecent_once, [&] () {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                m_facecent[idim] = makeDenseCutFab(m_sparse_facecent[idim], *m_cellflags);
+            }
+        });
+    }
     AMREX_ASSERT(m_facecent[0] != nullptr);
     return {AMREX_D_DECL(m_facecent[0], m_facecent[1], m_facecent[2])};
 }
@@ -141,6 +226,13 @@ EBDataCollection::getFaceCent () const
 Array<const MultiCutFab*, AMREX_SPACEDIM>
 EBDataCollection::getEdgeCent () const
 {
+    if (m_sparse_edgecent[0] != nullptr) {
+        std::call_once(m_edgecent_once, [&] () {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                m_edgecent[idim] = makeDenseCutFab(m_sparse_edgecent[idim], *m_cellflags);
+            }
+        });
+    }
     AMREX_ASSERT(m_edgecent[0] != nullptr);
     return {AMREX_D_DECL(m_edgecent[0], m_edgecent[1], m_edgecent[2])};
 }
@@ -148,8 +240,63 @@ EBDataCollection::getEdgeCent () const
 const MultiCutFab&
 EBDataCollection::getBndryNormal () const
 {
+    if (m_sparse_bndrynorm != nullptr) {
+        std::call_once(m_bndrynorm_once, [&] () {
+            m_bndrynorm = makeDenseCutFab(m_sparse_bndrynorm, *m_cellflags);
+        });
+    }
     AMREX_ASSERT(m_bndrynorm != nullptr);
     return *m_bndrynorm;
 }
 
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseCentroid () const
+{
+    AMREX_ASSERT(m_sparse_centroid != nullptr);
+    return *m_sparse_centroid;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseBndryCent () const
+{
+    AMREX_ASSERT(m_sparse_bndrycent != nullptr);
+    return *m_sparse_bndrycent;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseBndryArea () const
+{
+    AMREX_ASSERT(m_sparse_bndryarea != nullptr);
+    return *m_sparse_bndryarea;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseBndryNormal () const
+{
+    AMREX_ASSERT(m_sparse_bndrynorm != nullptr);
+    return *m_sparse_bndrynorm;
+}
+
+Array<const MultiSparseCutFab*, AMREX_SPACEDIM>
+EBDataCollection::getSparseAreaFrac () const
+{
+    AMREX_ASSERT(m_sparse_areafrac[0] != nullptr);
+    return {AMREX_D_DECL(m_sparse_areafrac[0], m_sparse_areafrac[1], m_sparse_areafrac[2])};
+}
+
+Array<const MultiSparseCutFab*, AMREX_SPACEDIM>
+EBDataCollection::getSparseFaceCent () const
+{
+    AMREX_ASSERT(m_sparse_facecent[0] != nullptr);
+    return {AMREX_D_DECL(m_sparse_facecent[0], m_sparse_facecent[1], m_sparse_facecent[2])};
+}
+
+Array<const MultiSparseCutFab*, AMREX_SPACEDIM>
+EBDataCollection::getSparseEdgeCent () const
+{
+    AMREX_ASSERT(m_sparse_edgecent[0] != nullptr);
+    return {AMREX_D_DECL(m_sparse_edgecent[0], m_sparse_edgecent[1], m_sparse_edgecent[2])};
+}
+
 }
@@ -8,6 +8,8 @@
 #include <AMReX_EB2_Level.H>
 #include <AMReX_EB2.H>
 
+#include <algorithm>
+
 namespace amrex
 {
 
@@ -15,10 +17,12 @@ EBFArrayBoxFactory::EBFArrayBoxFactory (const EB2::Level& a_level,
                                         const Geometry& a_geom,
                                         const BoxArray& a_ba,
                                         const DistributionMapping& a_dm,
-                                        const Vector<int>& a_ngrow, EBSupport a_support)
+                                        const Vector<int>& a_ngrow, EBSupport a_support,
+                                        EBCutStorage a_storage)
     : m_support(a_support),
       m_geom(a_geom),
-      m_ebdc(std::make_shared<EBDataCollection>(a_level,a_geom,a_ba,a_dm,a_ngrow,a_support)),
+      m_ebdc(std::make_shared<EBDataCollection>(a_level,a_geom,a_ba,a_dm,a_ngrow,a_support,
+                                                a_storage)),
       m_parent(&a_level)
 {}
 
@@ -109,36 +113,47 @@ EBFArrayBoxFactory::boxArray () const noexcept
     return m_ebdc->getMultiEBCellFlagFab().boxArray();
 }
 
+namespace {
+    int maxNGrow (const Vector<int>& a_ngrow)
+    {
+        return a_ngrow.empty() ? 0 : *std::max_element(a_ngrow.begin(), a_ngrow.end());
+    }
+}
+
 std::unique_ptr<EBFArrayBoxFactory>
 makeEBFabFactory (const Geometry& a_geom,
                   const BoxArray& a_ba,
                   const DistributionMapping& a_dm,
-                  const Vector<int>& a_ngrow, EBSupport a_support)
+                  const Vector<int>& a_ngrow, EBSupport a_support,
+                  EBCutStorage a_storage)
 {
     const EB2::IndexSpace& index_space = EB2::IndexSpace::top();
-    const EB2::Level& eb_level = index_space.getLevel(a_geom);
-    return std::make_unique<EBFArrayBoxFactory>(eb_level, a_geom, a_ba, a_dm, a_ngrow, a_support);
+    const EB2::Level& eb_level = index_space.getLevel(a_geom, a_ba, maxNGrow(a_ngrow));
+    return std::make_unique<EBFArrayBoxFactory>(eb_level, a_geom, a_ba, a_dm, a_ngrow, a_support,
+                                                a_storage);
 }
 
 std::unique_ptr<EBFArrayBoxFactory>
 makeEBFabFactory (const EB2::Level* eb_level,
                   const BoxArray& a_ba,
                   const DistributionMapping& a_dm,
-                  const Vector<int>& a_ngrow, EBSupport a_support)
+                  const Vector<int>& a_ngrow, EBSupport a_support,
+                  EBCutStorage a_storage)
 {
     return std::make_unique<EBFArrayBoxFactory>(*eb_level, eb_level->Geom(),
-                                                a_ba, a_dm, a_ngrow, a_support);
+                                                a_ba, a_dm, a_ngrow, a_support, a_storage);
 }
 
 std::unique_ptr<EBFArrayBoxFactory>
 makeEBFabFactory (const EB2::IndexSpace* index_space, const Geometry& a_geom,
                   const BoxArray& a_ba,
                   const DistributionMapping& a_dm,
-                  const Vector<int>& a_ngrow, EBSupport a_support)
+                  const Vector<int>& a_ngrow, EBSupport a_support,
+                  EBCutStorage a_storage)
 {
-    const EB2::Level& eb_level = index_space->getLevel(a_geom);
+    const EB2::Level& eb_level = index_space->getLevel(a_geom, a_ba, maxNGrow(a_ngrow));
     return std::make_unique<EBFArrayBoxFactory>(eb_level, a_geom,
-                                                a_ba, a_dm, a_ngrow, a_support);
+                                                a_ba, a_dm, a_ngrow, a_support, a_storage);
 }
 
 }
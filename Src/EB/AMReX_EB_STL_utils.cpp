@@ -1,7 +1,10 @@
 #include <AMReX_EB_STL_utils.H>
 #include <AMReX_EB_triGeomOps_K.H>
 #include <AMReX_IntConv.H>
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <numeric>
 
 namespace amrex
 {
@@ -89,6 +92,308 @@ namespace {
             return std::make_pair(false,0.0_rt);
         }
     }
+
+    // Does the line segment a+t*d, 0 <= t <= 1, overlap the box?
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool segment_box_overlaps (Real const a[3], Real const d[3],
+                               XDim3 const& bmin, XDim3 const& bmax)
+    {
+        Real const lo[] = {bmin.x, bmin.y, bmin.z};
+        Real const hi[] = {bmax.x, bmax.y, bmax.z};
+        Real tmin = 0._rt;
+        Real tmax = 1._rt;
+        for (int dir = 0; dir < 3; ++dir) {
+            if (d[dir] == 0._rt) {
+                if (a[dir] < lo[dir] || a[dir] > hi[dir]) {
+                    return false;
+                }
+            } else {
+                Real t1 = (lo[dir]-a[dir]) / d[dir];
+                Real t2 = (hi[dir]-a[dir]) / d[dir];
+                tmin = amrex::max(tmin, amrex::min(t1,t2));
+                tmax = amrex::min(tmax, amrex::max(t1,t2));
+                if (tmin > tmax) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // The number of triangles intersected by line ab.  If nodes is not
+    // null, the bounding volume hierarchy is used, and the leaves hold the
+    // triangles index[first..first+count).
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    int num_tri_intersects (Real a[3], Real b[3], STLtools::Triangle const* tri_pts,
+                            int num_triangles, STLtools::BVHNode const* nodes,
+                            int const* index)
+    {
+        int num_intersects = 0;
+        if (nodes == nullptr) {
+            for (int tr=0; tr < num_triangles; ++tr) {
+                if (line_tri_intersects(a, b, tri_pts[tr])) {
+                    ++num_intersects;
+                }
+            }
+        } else {
+            Real d[] = {b[0]-a[0], b[1]-a[1], b[2]-a[2]};
+            int stack[STLtools::bvh_max_depth+1];
+            int nstack = 0;
+            int inode = 0;
+            while (true) {
+                STLtools::BVHNode const& node = nodes[inode];
+                if (segment_box_overlaps(a, d, node.bmin, node.bmax)) {
+                    if (node.count == 0) {
+                        stack[nstack++] = node.first;
+                        ++inode;
+                        continue;
+                    }
+                    for (int n = node.first; n < node.first+node.count; ++n) {
+                        if (line_tri_intersects(a, b, tri_pts[index[n]])) {
+                            ++num_intersects;
+                        }
+                    }
+                }
+                if (nstack == 0) { break; }
+                inode = stack[--nstack];
+            }
+        }
+        return num_intersects;
+    }
+
+    // Cyclic permutation of the coordinates so that direction idim becomes x.
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    XDim3 rotate (XDim3 const& v, int idim)
+    {
+        if (idim == 0) {
+            return v;
+        } else if (idim == 1) {
+            return XDim3{v.y, v.z, v.x};
+        } else {
+            return XDim3{v.z, v.x, v.y};
+        }
+    }
+
+    // Does the edge (x1,y,z)->(x2,y,z) in the coordinates rotated for
+    // direction idim intersect a triangle?  If there are several, the
+    // first triangle in the file is used.  If nodes is not null, the
+    // bounding volume hierarchy is used.
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    std::pair<bool,Real> edge_intersects (int idim, Real x1, Real x2, Real y, Real z,
+                                          Real dlevset, STLtools::Triangle const* tri_pts,
+                                          XDim3 const* tri_norm, int num_triangles,
+                                          STLtools::BVHNode const* nodes, int const* index)
+    {
+        if (nodes == nullptr) {
+            for (int it=0; it < num_triangles; ++it) {
+                auto const& tri = tri_pts[it];
+                auto tmp = edge_tri_intersects(x1, x2, y, z,
+                                               rotate(tri.v1,idim), rotate(tri.v2,idim),
+                                               rotate(tri.v3,idim), rotate(tri_norm[it],idim),
+                                               dlevset);
+                if (tmp.first) {
+                    return tmp;
+                }
+            }
+        } else {
+            std::pair<bool,Real> r(false,0.0_rt);
+            int rtri = num_triangles;
+            int stack[STLtools::bvh_max_depth+1];
+            int nstack = 0;
+            int inode = 0;
+            while (true) {
+                STLtools::BVHNode const& node = nodes[inode];
+                XDim3 lo = rotate(node.bmin, idim);
+                XDim3 hi = rotate(node.bmax, idim);
+                if (x1 <= hi.x && x2 >= lo.x && y >= lo.y && y <= hi.y && z >= lo.z && z <= hi.z)
+                {
+                    if (node.count == 0) {
+                        stack[nstack++] = node.first;
+                        ++inode;
+                        continue;
+                    }
+                    for (int n = node.first; n < node.first+node.count; ++n) {
+                        int it = index[n];
+                        if (it > rtri) { continue; }
+                        auto const& tri = tri_pts[it];
+                        auto tmp = edge_tri_intersects(x1, x2, y, z,
+                                                       rotate(tri.v1,idim), rotate(tri.v2,idim),
+                                                       rotate(tri.v3,idim), rotate(tri_norm[it],idim),
+                                                       dlevset);
+                        if (tmp.first) {
+                            r = tmp;
+                            rtri = it;
+                        }
+                    }
+                }
+                if (nstack == 0) { break; }
+                inode = stack[--nstack];
+            }
+            return r;
+        }
+        return std::make_pair(false,0.0_rt);
+    }
+
+    // Top-down construction of a bounding volume hierarchy with the binned
+    // surface area heuristic.
+    class BVHBuilder
+    {
+    public:
+        static constexpr int max_leaf_size = 4;
+        static constexpr int nbins = 16;
+
+        BVHBuilder (STLtools::Triangle const* tri, int ntri)
+            : m_index(ntri), m_bmin(ntri), m_bmax(ntri), m_cent(ntri)
+        {
+            Real maxabs = 0._rt;
+            for (int i = 0; i < ntri; ++i) {
+                auto const& t = tri[i];
+                m_bmin[i] = XDim3{amrex::min(t.v1.x,t.v2.x,t.v3.x),
+                                  amrex::min(t.v1.y,t.v2.y,t.v3.y),
+                                  amrex::min(t.v1.z,t.v2.z,t.v3.z)};
+                m_bmax[i] = XDim3{amrex::max(t.v1.x,t.v2.x,t.v3.x),
+                                  amrex::max(t.v1.y,t.v2.y,t.v3.y),
+                                  amrex::max(t.v1.z,t.v2.z,t.v3.z)};
+                m_cent[i] = XDim3{0.5_rt*(m_bmin[i].x+m_bmax[i].x),
+                                  0.5_rt*(m_bmin[i].y+m_bmax[i].y),
+                                  0.5_rt*(m_bmin[i].z+m_bmax[i].z)};
+                maxabs = std::max({maxabs, std::abs(m_bmin[i].x), std::abs(m_bmin[i].y),
+                                   std::abs(m_bmin[i].z), std::abs(m_bmax[i].x),
+                                   std::abs(m_bmax[i].y), std::abs(m_bmax[i].z)});
+            }
+            // The node boxes are padded so that round-off in the box tests
+            // cannot lose a triangle.
+            m_pad = 16._rt * std::numeric_limits<Real>::epsilon() * (1._rt + maxabs);
+            std::iota(m_index.begin(), m_index.end(), 0);
+            if (ntri > 0) {
+                m_nodes.reserve(2*(ntri/max_leaf_size+1));
+                build(0, ntri, 0);
+            }
+        }
+
+        std::vector<STLtools::BVHNode> const& nodes () const { return m_nodes; }
+        //! The triangles in the order of the leaves
+        std::vector<int> const& index () const { return m_index; }
+
+    private:
+
+        static Real area (XDim3 const& lo, XDim3 const& hi)
+        {
+            Real dx = hi.x-lo.x, dy = hi.y-lo.y, dz = hi.z-lo.z;
+            return dx*dy + dy*dz + dz*dx;
+        }
+
+        static Real comp (XDim3 const& v, int dir)
+        {
+            return (dir == 0) ? v.x : ((dir == 1) ? v.y : v.z);
+        }
+
+        static void grow (XDim3& lo, XDim3& hi, XDim3 const& plo, XDim3 const& phi)
+        {
+            lo = XDim3{std::min(lo.x,plo.x), std::min(lo.y,plo.y), std::min(lo.z,plo.z)};
+            hi = XDim3{std::max(hi.x,phi.x), std::max(hi.y,phi.y), std::max(hi.z,phi.z)};
+        }
+
+        int build (int begin, int end, int depth)
+        {
+            constexpr Real big = std::numeric_limits<Real>::max();
+            const int inode = static_cast<int>(m_nodes.size());
+            m_nodes.push_back(STLtools::BVHNode{});
+
+            XDim3 lo{big,big,big}, hi{-big,-big,-big};
+            XDim3 clo{big,big,big}, chi{-big,-big,-big};
+            for (int k = begin; k < end; ++k) {
+                int i = m_index[k];
+                grow(lo, hi, m_bmin[i], m_bmax[i]);
+                grow(clo, chi, m_cent[i], m_cent[i]);
+            }
+            m_nodes[inode].bmin = XDim3{lo.x-m_pad, lo.y-m_pad, lo.z-m_pad};
+            m_nodes[inode].bmax = XDim3{hi.x+m_pad, hi.y+m_pad, hi.z+m_pad};
+
+            const int n = end - begin;
+            int dir = 0;
+            Real extent = chi.x - clo.x;
+            if (chi.y - clo.y > extent) { dir = 1; extent = chi.y - clo.y; }
+            if (chi.z - clo.z > extent) { dir = 2; extent = chi.z - clo.z; }
+
+            int mid = -1;
+            if (n > max_leaf_size && depth < STLtools::bvh_max_depth && extent > 0._rt)
+            {
+                const Real cmin = comp(clo,dir);
+                const Real scale = nbins / extent;
+                auto bin_of = [&] (int i) {
+                    int b = static_cast<int>((comp(m_cent[i],dir)-cmin)*scale);
+                    return std::min(std::max(b,0), nbins-1);
+                };
+
+                int count[nbins] = {};
+                XDim3 blo[nbins], bhi[nbins];
+                for (int b = 0; b < nbins; ++b) {
+                    blo[b] = XDim3{big,big,big};
+                    bhi[b] = XDim3{-big,-big,-big};
+                }
+                for (int k = begin; k < end; ++k) {
+                    int i = m_index[k];
+                    int b = bin_of(i);
+                    ++count[b];
+                    grow(blo[b], bhi[b], m_bmin[i], m_bmax[i]);
+                }
+
+                // Sweep from the right to get the cost of the right sides.
+                Real right_cost[nbins];
+                {
+                    XDim3 rlo{big,big,big}, rhi{-big,-big,-big};
+                    int rcount = 0;
+                    for (int b = nbins-1; b > 0; --b) {
+                        grow(rlo, rhi, blo[b], bhi[b]);
+                        rcount += count[b];
+                        right_cost[b] = (rcount > 0) ? rcount*area(rlo,rhi) : 0._rt;
+                    }
+                }
+
+                Real best_cost = big;
+                int best_bin = -1;
+                {
+                    XDim3 llo{big,big,big}, lhi{-big,-big,-big};
+                    int lcount = 0;
+                    for (int b = 0; b < nbins-1; ++b) {
+                        grow(llo, lhi, blo[b], bhi[b]);
+                        lcount += count[b];
+                        if (lcount == 0 || lcount == n) { continue; }
+                        Real cost = lcount*area(llo,lhi) + right_cost[b+1];
+                        if (cost < best_cost) {
+                            best_cost = cost;
+                            best_bin = b;
+                        }
+                    }
+                }
+
+                // Split if it is cheaper than testing all the triangles, or
+                // if the leaf would be too big.
+                if (best_bin >= 0 && (best_cost < n*area(lo,hi) || n > 4*max_leaf_size)) {
+                    auto it = std::partition(m_index.begin()+begin, m_index.begin()+end,
+                                             [&] (int i) { return bin_of(i) <= best_bin; });
+                    mid = static_cast<int>(it - m_index.begin());
+                }
+            }
+
+            if (mid <= begin || mid >= end) {
+                m_nodes[inode].first = begin;
+                m_nodes[inode].count = n;
+            } else {
+                build(begin, mid, depth+1);
+                int right = build(mid, end, depth+1);
+                m_nodes[inode].first = right;
+                m_nodes[inode].count = 0;
+            }
+            return inode;
+        }
+
+        std::vector<int> m_index;
+        std::vector<XDim3> m_bmin, m_bmax, m_cent;
+        std::vector<STLtools::BVHNode> m_nodes;
+        Real m_pad;
+    };
 }
 
 void
@@ -235,6 +540,29 @@ STLtools::read_ascii_stl_file (std::string const& fname, Real scale,
     }
 }
 
+void
+STLtools::build_bvh ()
+{
+    BL_PROFILE("STLtools::build_bvh()");
+
+    double t0 = amrex::second();
+
+    BVHBuilder builder(m_tri_pts_h.data(), m_num_tri);
+
+    auto const& nodes = builder.nodes();
+    auto const& index = builder.index();
+    m_bvh_nodes_d.resize(nodes.size());
+    m_bvh_index_d.resize(index.size());
+    Gpu::copyAsync(Gpu::hostToDevice, nodes.begin(), nodes.end(), m_bvh_nodes_d.begin());
+    Gpu::copyAsync(Gpu::hostToDevice, index.begin(), index.end(), m_bvh_index_d.begin());
+    Gpu::streamSynchronize();
+
+    if (amrex::Verbose() > 0) {
+        amrex::Print() << "    BVH with " << nodes.size() << " nodes built in "
+                       << amrex::second()-t0 << " seconds" << std::endl;
+    }
+}
+
 void
 STLtools::prepare ()
 {
@@ -242,6 +570,15 @@ STLtools::prepare ()
     if (!ParallelDescriptor::IOProcessor()) {
         m_tri_pts_h.resize(m_num_tri);
     }
+    ParallelDescriptor::Bcast(reinterpret_cast<char*>(m_tri_pts_h.data()),
+                              m_num_tri*sizeof(Triangle));
+
+    if (m_use_bvh) {
+        build_bvh();
+    } else {
+        m_bvh_nodes_d.clear();
+        m_bvh_index_d.clear();
+    }
 
     //device vectors
     m_tri_pts_d.resize(m_num_tri);
@@ -423,6 +760,8 @@ STLtools::fill (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
     const auto dx  = geom.CellSizeArray();
 
     const Triangle* tri_pts = m_tri_pts_d.data();
+    const BVHNode* bvh_nodes = m_bvh_nodes_d.empty() ? nullptr : m_bvh_nodes_d.data();
+    const int* bvh_index = m_bvh_index_d.data();
     XDim3 ptmin = m_ptmin;
     XDim3 ptmax = m_ptmax;
     XDim3 ptref = m_ptref;
@@ -447,11 +786,8 @@ STLtools::fill (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
             coords[2] >= ptmin.z && coords[2] <= ptmax.z)
         {
             Real pr[]={ptref.x, ptref.y, ptref.z};
-            for (int tr=0; tr < num_triangles; ++tr) {
-                if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                    ++num_intersects;
-                }
-            }
+            num_intersects = num_tri_intersects(pr, coords, tri_pts, num_triangles,
+                                                bvh_nodes, bvh_index);
         }
         ma[box_no](i,j,k) = (num_intersects % 2 == 0) ? reference_value : other_value;
     });
@@ -491,6 +827,8 @@ STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
     {
         int num_triangles = m_num_tri;
         const Triangle* tri_pts = m_tri_pts_d.data();
+        const BVHNode* bvh_nodes = m_bvh_nodes_d.empty() ? nullptr : m_bvh_nodes_d.data();
+        const int* bvh_index = m_bvh_index_d.data();
         XDim3 ptmin = m_ptmin;
         XDim3 ptmax = m_ptmax;
         XDim3 ptref = m_ptref;
@@ -517,11 +855,8 @@ STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
                 coords[2] >= ptmin.z && coords[2] <= ptmax.z)
             {
                 Real pr[]={ptref.x, ptref.y, ptref.z};
-                for (int tr=0; tr < num_triangles; ++tr) {
-                    if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                        ++num_intersects;
-                    }
-                }
+                num_intersects = num_tri_intersects(pr, coords, tri_pts, num_triangles,
+                                                    bvh_nodes, bvh_index);
             }
 
             return (num_intersects % 2 == 0) ? ref_value : 1-ref_value;
@@ -548,6 +883,8 @@ STLtools::fillFab (BaseFab<Real>& levelset, const Geometry& geom, RunOn, Box con
     const auto dx  = geom.CellSizeArray();
 
     const Triangle* tri_pts = m_tri_pts_d.data();
+    const BVHNode* bvh_nodes = m_bvh_nodes_d.empty() ? nullptr : m_bvh_nodes_d.data();
+    const int* bvh_index = m_bvh_index_d.data();
     XDim3 ptmin = m_ptmin;
     XDim3 ptmax = m_ptmax;
     XDim3 ptref = m_ptref;
@@ -572,11 +909,8 @@ STLtools::fillFab (BaseFab<Real>& levelset, const Geometry& geom, RunOn, Box con
             coords[2] >= ptmin.z && coords[2] <= ptmax.z)
         {
             Real pr[]={ptref.x, ptref.y, ptref.z};
-            for (int tr=0; tr < num_triangles; ++tr) {
-                if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                    ++num_intersects;
-                }
-            }
+            num_intersects = num_tri_intersects(pr, coords, tri_pts, num_triangles,
+                                                bvh_nodes, bvh_index);
         }
         a(i,j,k) = (num_intersects % 2 == 0) ? reference_value : other_value;
     });
@@ -595,6 +929,8 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
 
     const Triangle* tri_pts = m_tri_pts_d.data();
     const XDim3* tri_norm = m_tri_normals_d.data();
+    const BVHNode* bvh_nodes = m_bvh_nodes_d.empty() ? nullptr : m_bvh_nodes_d.data();
+    const int* bvh_index = m_bvh_index_d.data();
 
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         Array4<Real> const& inter = inter_arr[idim];
@@ -612,63 +948,28 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
                          plo[2]+k*dx[2]
 #endif
                 };
+                // The edge goes from p1 to p2 in direction idim.  The
+                // coordinates are rotated so that idim becomes x.
+                XDim3 p = rotate(p1, idim);
+                Real x2;
+                Real dlevset;
                 if (idim == 0) {
-                    Real x2 = plo[0]+(i+1)*dx[0];
-                    int it;
-                    for (it=0; it < num_triangles; ++it) {
-                        auto const& tri = tri_pts[it];
-                        auto tmp = edge_tri_intersects(p1.x, x2, p1.y, p1.z,
-                                                       tri.v1, tri.v2, tri.v3,
-                                                       tri_norm[it],
-                                                       lst(i+1,j,k)-lst(i,j,k));
-                        if (tmp.first) {
-                            r = tmp.second;
-                            break;
-                        }
-                    }
-                    if (it == num_triangles) {
-                        r = (lst(i,j,k) > 0._rt) ? p1.x : x2;
-                    }
+                    x2 = plo[0]+(i+1)*dx[0];
+                    dlevset = lst(i+1,j,k)-lst(i,j,k);
                 } else if (idim == 1) {
-                    Real y2 = plo[1]+(j+1)*dx[1];
-                    int it;
-                    for (it=0; it < num_triangles; ++it) {
-                        auto const& tri = tri_pts[it];
-                        auto const& norm = tri_norm[it];
-                        auto tmp = edge_tri_intersects(p1.y, y2, p1.z, p1.x,
-                                                       {tri.v1.y, tri.v1.z, tri.v1.x},
-                                                       {tri.v2.y, tri.v2.z, tri.v2.x},
-                                                       {tri.v3.y, tri.v3.z, tri.v3.x},
-                                                       {  norm.y,   norm.z,   norm.x},
-                                                       lst(i,j+1,k)-lst(i,j,k));
-                        if (tmp.first) {
-                            r = tmp.second;
-                            break;
-                        }
-                    }
-                    if (it == num_triangles) {
-                        r = (lst(i,j,k) > 0._rt) ? p1.y : y2;
-                    }
+                    x2 = plo[1]+(j+1)*dx[1];
+                    dlevset = lst(i,j+1,k)-lst(i,j,k);
                 } else {
-                    Real z2 = plo[2]+(k+1)*dx[2];
-                    int it;
-                    for (it=0; it < num_triangles; ++it) {
-                        auto const& tri = tri_pts[it];
-                        auto const& norm = tri_norm[it];
-                        auto tmp = edge_tri_intersects(p1.z, z2, p1.x, p1.y,
-                                                       {tri.v1.z, tri.v1.x, tri.v1.y},
-                                                       {tri.v2.z, tri.v2.x, tri.v2.y},
-                                                       {tri.v3.z, tri.v3.x, tri.v3.y},
-                                                       {  norm.z,   norm.x,   norm.y},
-                                                       lst(i,j,k+1)-lst(i,j,k));
-                        if (tmp.first) {
-                            r = tmp.second;
-                            break;
-                        }
-                    }
-                    if (it == num_triangles) {
-                        r = (lst(i,j,k) > 0._rt) ? p1.z : z2;
-                    }
+                    x2 = plo[2]+(k+1)*dx[2];
+                    dlevset = lst(i,j,k+1)-lst(i,j,k);
+                }
+                auto tmp = edge_intersects(idim, p.x, x2, p.y, p.z, dlevset,
+                                           tri_pts, tri_norm, num_triangles, bvh_nodes,
+                                           bvh_index);
+                if (tmp.first) {
+                    r = tmp.second;
+                } else {
+                    r = (lst(i,j,k) > 0._rt) ? p.x : x2;
                 }
             }
             inter(i,j,k) = r;
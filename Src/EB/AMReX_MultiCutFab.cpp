@@ -34,11 +34,11 @@ MultiCutFab::define (const BoxArray& ba, const DistributionMapping& dm,
 void
 MultiCutFab::remove ()
 {
-    for (MFIter mfi(m_data); mfi.isValid(); ++mfi)
+    for (int K : m_data.IndexArray())
     {
-        if (!ok(mfi))
+        if (!ok(K))
         {
-            delete m_data.release(mfi);
+            delete m_data.release(K);
         }
     }
 }
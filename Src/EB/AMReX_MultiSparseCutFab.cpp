@@ -0,0 +1,252 @@
+
+#include <AMReX_MultiSparseCutFab.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Scan.H>
+
+#ifdef AMREX_USE_OMP
+#include <omp.h>
+#endif
+
+namespace amrex {
+
+Long
+SparseCutFab::nBytes () const noexcept
+{
+    return m_index.nBytes()
+        + static_cast<Long>(m_cells.size()*sizeof(int))
+        + static_cast<Long>(m_data.size()*sizeof(Real));
+}
+
+SparseCutArray<Real const>
+SparseCutFab::const_array () const noexcept
+{
+    SparseCutArray<Real const> r;
+    r.index = m_index.const_array();
+    r.data = m_data.data();
+    r.cells = m_cells.data();
+    r.nslots = m_nslots;
+    r.ncomp = m_ncomp;
+    r.defaults[0] = m_defaults[0];
+    r.defaults[1] = m_defaults[1];
+    return r;
+}
+
+SparseCutArray<Real>
+SparseCutFab::array () noexcept
+{
+    SparseCutArray<Real> r;
+    r.index = m_index.const_array();
+    r.data = m_data.data();
+    r.cells = m_cells.data();
+    r.nslots = m_nslots;
+    r.ncomp = m_ncomp;
+    r.defaults[0] = m_defaults[0];
+    r.defaults[1] = m_defaults[1];
+    return r;
+}
+
+MultiSparseCutFab::MultiSparseCutFab (const BoxArray& ba, const DistributionMapping& dm,
+                                      int ncomp, int ngrow, const FabArray<EBCellFlagFab>& cellflags)
+{
+    define(ba, dm, ncomp, ngrow, cellflags);
+}
+
+void
+MultiSparseCutFab::define (const BoxArray& ba, const DistributionMapping& dm,
+                           int ncomp, int ngrow, const FabArray<EBCellFlagFab>& cellflags)
+{
+    m_data.define(ba, dm);
+    m_cellflags = &cellflags;
+    m_ncomp = ncomp;
+    m_ngrow = ngrow;
+}
+
+void
+MultiSparseCutFab::pack (const MultiFab& mf, Vector<Real> const& defaults)
+{
+    AMREX_ASSERT(mf.boxArray() == boxArray() && mf.DistributionMap() == DistributionMap() &&
+                 mf.nComp() == m_ncomp && mf.nGrow() == m_ngrow);
+
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi)
+    {
+        pack(mfi.index(), mf[mfi], defaults);
+    }
+}
+
+void
+MultiSparseCutFab::pack (int global_box_index, const FArrayBox& fab, Vector<Real> const& defaults)
+{
+    AMREX_ALWAYS_ASSERT(defaults.size() <= 2);
+
+    const int ncomp = m_ncomp;
+    const int ndefaults = defaults.size();
+    Real d0 = (ndefaults > 0) ? defaults[0] : Real(0.0);
+    Real d1 = (ndefaults > 1) ? defaults[1] : Real(0.0);
+
+    SparseCutFab& sfab = m_data[global_box_index];
+    sfab.m_ncomp = ncomp;
+    sfab.m_defaults[0] = d0;
+    sfab.m_defaults[1] = d1;
+
+    if (!ok(global_box_index)) {
+        sfab.m_index.clear();
+        sfab.m_cells.clear();
+        sfab.m_data.clear();
+        sfab.m_nslots = 0;
+        return;
+    }
+
+    const Box bx = amrex::grow(boxArray()[global_box_index], m_ngrow);
+    AMREX_ASSERT(fab.box().contains(bx) && fab.nComp() == ncomp);
+    const int npts = static_cast<int>(bx.numPts());
+    sfab.m_index.resize(bx, 1);
+    int* AMREX_RESTRICT p_index = sfab.m_index.dataPtr();
+    Array4<Real const> const& a = fab.const_array();
+
+    // Code each entry with its default number, or 1 if it is stored.
+    amrex::ParallelFor(npts, [=] AMREX_GPU_DEVICE (int icell) noexcept
+    {
+        const auto ijk = bx.atOffset3d(icell);
+        int code = 1;
+        for (int m = ndefaults-1; m >= 0; --m) {
+            const Real dval = (m == 0) ? d0 : d1;
+            bool all = true;
+            for (int n = 0; n < ncomp; ++n) {
+                all = all && (a(ijk[0],ijk[1],ijk[2],n) == dval);
+            }
+            if (all) { code = -1-m; }
+        }
+        p_index[icell] = code;
+    });
+
+    const int nslots = Scan::PrefixSum<int>
+        (npts,
+         [=] AMREX_GPU_DEVICE (int icell) -> int
+         {
+             return (p_index[icell] > 0) ? 1 : 0;
+         },
+         [=] AMREX_GPU_DEVICE (int icell, int const& x)
+         {
+             if (p_index[icell] > 0) { p_index[icell] = x; }
+         },
+         Scan::Type::exclusive, Scan::retSum);
+
+    sfab.m_nslots = nslots;
+    sfab.m_cells.resize(nslots);
+    sfab.m_data.resize(static_cast<std::size_t>(nslots)*ncomp);
+    if (nslots > 0) {
+        int* AMREX_RESTRICT p_cells = sfab.m_cells.data();
+        Real* AMREX_RESTRICT p_data = sfab.m_data.data();
+        amrex::ParallelFor(npts, [=] AMREX_GPU_DEVICE (int icell) noexcept
+        {
+            const int s = p_index[icell];
+            if (s >= 0) {
+                const auto ijk = bx.atOffset3d(icell);
+                p_cells[s] = icell;
+                for (int n = 0; n < ncomp; ++n) {
+                    p_data[s+n*nslots] = a(ijk[0],ijk[1],ijk[2],n);
+                }
+            }
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+void
+MultiSparseCutFab::unpack (MultiCutFab& mcf) const
+{
+    AMREX_ASSERT(mcf.boxArray() == boxArray() && mcf.nComp() == m_ncomp);
+    const int ncomp = m_ncomp;
+    // No MFIter here, because this can be called inside an OpenMP parallel
+    // region when the dense data are built on demand.
+    for (int K : m_data.IndexArray())
+    {
+        if (ok(K)) {
+            Array4<Real> const& d = mcf[K].array();
+            SparseCutArray<Real const> const& s = m_data[K].const_array();
+            const Box b = amrex::grow(boxArray()[K], m_ngrow);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D(b, ncomp, i, j, k, n,
+            {
+                d(i,j,k,n) = s(i,j,k,n);
+            });
+        }
+    }
+    Gpu::streamSynchronize();
+}
+
+const SparseCutFab&
+MultiSparseCutFab::operator[] (const MFIter& mfi) const noexcept
+{
+    AMREX_ASSERT(ok(mfi));
+    return m_data[mfi];
+}
+
+SparseCutFab&
+MultiSparseCutFab::operator[] (const MFIter& mfi) noexcept
+{
+    AMREX_ASSERT(ok(mfi));
+    return m_data[mfi];
+}
+
+SparseCutArray<Real const>
+MultiSparseCutFab::const_array (const MFIter& mfi) const noexcept
+{
+    AMREX_ASSERT(ok(mfi));
+    return m_data[mfi].const_array();
+}
+
+SparseCutArray<Real const>
+MultiSparseCutFab::array (const MFIter& mfi) const noexcept
+{
+    AMREX_ASSERT(ok(mfi));
+    return m_data[mfi].const_array();
+}
+
+SparseCutArray<Real>
+MultiSparseCutFab::array (const MFIter& mfi) noexcept
+{
+    AMREX_ASSERT(ok(mfi));
+    return m_data[mfi].array();
+}
+
+const SparseCutFab&
+MultiSparseCutFab::operator[] (int global_box_index) const noexcept
+{
+    AMREX_ASSERT(ok(global_box_index));
+    return m_data[global_box_index];
+}
+
+bool
+MultiSparseCutFab::ok (const MFIter& mfi) const noexcept
+{
+    return (*m_cellflags)[mfi].getType() == FabType::singlevalued;
+}
+
+bool
+MultiSparseCutFab::ok (int global_box_index) const noexcept
+{
+    return (*m_cellflags)[global_box_index].getType() == FabType::singlevalued;
+}
+
+Long
+MultiSparseCutFab::nBytes () const noexcept
+{
+    Long r = 0;
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi) {
+        r += m_data[mfi].nBytes();
+    }
+    return r;
+}
+
+Long
+MultiSparseCutFab::nSlots () const noexcept
+{
+    Long r = 0;
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi) {
+        r += m_data[mfi].nSlots();
+    }
+    return r;
+}
+
+}
@@ -0,0 +1,482 @@
+#include <AMReX_FFT.H>
+#include <AMReX_Loop.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace amrex { namespace FFT {
+
+namespace {
+
+AMREX_FORCE_INLINE
+GpuComplex<Real> conj (GpuComplex<Real> const& z) noexcept
+{
+    return GpuComplex<Real>(z.real(), -z.imag());
+}
+
+// z times -i if is_forward, otherwise z times i
+AMREX_FORCE_INLINE
+GpuComplex<Real> mul_mi (GpuComplex<Real> const& z, bool is_forward) noexcept
+{
+    return is_forward ? GpuComplex<Real>( z.imag(), -z.real())
+                      : GpuComplex<Real>(-z.imag(),  z.real());
+}
+
+// exp(-2 pi i j/n)
+GpuComplex<Real> unit_root (Long j, Long n) noexcept
+{
+    constexpr double twopi = 6.283185307179586476925286766559;
+    double const theta = twopi * static_cast<double>(j) / static_cast<double>(n);
+    return GpuComplex<Real>(static_cast<Real>(std::cos(theta)),
+                            static_cast<Real>(-std::sin(theta)));
+}
+
+DistributionMapping make_pencil_dm (BoxArray const& ba)
+{
+    Vector<int> pmap(ba.size());
+    int const nprocs = ParallelDescriptor::NProcs();
+    for (int i = 0, N = pmap.size(); i < N; ++i) {
+        pmap[i] = i % nprocs;
+    }
+    return DistributionMapping(std::move(pmap));
+}
+
+// 1D complex FFTs of all the lines in direction dir
+void transform_lines (cMultiFab& mf, int dir, Plan1D const& plan, bool is_forward)
+{
+    int const n = plan.size();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        Box const& bx = mfi.validbox();
+        AMREX_ASSERT(bx.length(dir) == n);
+        auto const& a = mf.array(mfi);
+        Box cross_section = bx;
+        cross_section.setBig(dir, bx.smallEnd(dir));
+        Long const nlines = cross_section.numPts();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        {
+            Vector<GpuComplex<Real> > in(n), out(n);
+#ifdef AMREX_USE_OMP
+#pragma omp for
+#endif
+            for (Long iline = 0; iline < nlines; ++iline) {
+                IntVect iv = cross_section.atOffset(iline);
+                for (int m = 0; m < n; ++m) {
+                    iv[dir] = bx.smallEnd(dir) + m;
+                    in[m] = a(iv);
+                }
+                if (is_forward) {
+                    plan.forward(in.data(), out.data());
+                } else {
+                    plan.backward(in.data(), out.data());
+                }
+                for (int m = 0; m < n; ++m) {
+                    iv[dir] = bx.smallEnd(dir) + m;
+                    a(iv) = out[m];
+                }
+            }
+        }
+    }
+}
+
+}
+
+Plan1D::Plan1D (int n)
+    : m_n(n)
+{
+    AMREX_ALWAYS_ASSERT(n >= 1);
+
+    int r = n;
+    while (r % 4 == 0) {
+        m_factors.push_back(4);
+        r /= 4;
+    }
+    while (r % 2 == 0) {
+        m_factors.push_back(2);
+        r /= 2;
+    }
+    for (int p = 3; p*p <= r; p += 2) {
+        while (r % p == 0) {
+            m_factors.push_back(p);
+            r /= p;
+        }
+    }
+    if (r > 1 || m_factors.empty()) {
+        m_factors.push_back(r);
+    }
+
+    m_twiddle.resize(n);
+    for (int j = 0; j < n; ++j) {
+        m_twiddle[j] = unit_root(j, n);
+    }
+}
+
+void Plan1D::forward (GpuComplex<Real> const* in, GpuComplex<Real>* out) const noexcept
+{
+    transform(in, out, m_n, 1, 0, true);
+}
+
+void Plan1D::backward (GpuComplex<Real> const* in, GpuComplex<Real>* out) const noexcept
+{
+    transform(in, out, m_n, 1, 0, false);
+}
+
+void Plan1D::transform (GpuComplex<Real> const* in, GpuComplex<Real>* out,
+                        int n, int stride, int ifac, bool is_forward) const noexcept
+{
+    // The n points in[0], in[stride], ... are split into p interleaved
+    // sequences of length m, whose transforms are combined by butterflies.
+    // Note that n*stride is m_n on every level.
+    int const p = m_factors[ifac];
+    int const m = n/p;
+    if (m == 1) {
+        for (int q = 0; q < p; ++q) {
+            out[q] = in[q*stride];
+        }
+    } else {
+        for (int q = 0; q < p; ++q) {
+            transform(in+q*stride, out+q*m, m, stride*p, ifac+1, is_forward);
+        }
+    }
+
+    // exp(-+2 pi i x/n)
+    auto twiddle = [&] (int x) -> GpuComplex<Real>
+    {
+        GpuComplex<Real> const& w = m_twiddle[x*stride];
+        return is_forward ? w : conj(w);
+    };
+
+    if (p == 2) {
+        for (int k = 0; k < m; ++k) {
+            GpuComplex<Real> const y0 = out[k];
+            GpuComplex<Real> const y1 = out[k+m] * twiddle(k);
+            out[k  ] = y0 + y1;
+            out[k+m] = y0 - y1;
+        }
+    } else if (p == 3) {
+        Real const s = std::sqrt(Real(3.))*Real(0.5);
+        for (int k = 0; k < m; ++k) {
+            GpuComplex<Real> const y0 = out[k];
+            GpuComplex<Real> const y1 = out[k+m] * twiddle(k);
+            GpuComplex<Real> const y2 = out[k+2*m] * twiddle(2*k);
+            GpuComplex<Real> const t = y1 + y2;
+            GpuComplex<Real> const a = y0 - Real(0.5)*t;
+            GpuComplex<Real> const b = mul_mi(y1-y2, is_forward) * s;
+            out[k    ] = y0 + t;
+            out[k+  m] = a + b;
+            out[k+2*m] = a - b;
+        }
+    } else if (p == 4) {
+        for (int k = 0; k < m; ++k) {
+            GpuComplex<Real> const y0 = out[k];
+            GpuComplex<Real> const y1 = out[k+m] * twiddle(k);
+            GpuComplex<Real> const y2 = out[k+2*m] * twiddle(2*k);
+            GpuComplex<Real> const y3 = out[k+3*m] * twiddle(3*k);
+            GpuComplex<Real> const t0 = y0 + y2;
+            GpuComplex<Real> const t1 = y0 - y2;
+            GpuComplex<Real> const t2 = y1 + y3;
+            GpuComplex<Real> const t3 = mul_mi(y1 - y3, is_forward);
+            out[k    ] = t0 + t2;
+            out[k+  m] = t1 + t3;
+            out[k+2*m] = t0 - t2;
+            out[k+3*m] = t1 - t3;
+        }
+    } else if (p == 5) {
+        GpuComplex<Real> const w1 = unit_root(1,5);
+        GpuComplex<Real> const w2 = unit_root(2,5);
+        Real const c1 = w1.real(), s1 = -w1.imag();
+        Real const c2 = w2.real(), s2 = -w2.imag();
+        for (int k = 0; k < m; ++k) {
+            GpuComplex<Real> const y0 = out[k];
+            GpuComplex<Real> const y1 = out[k+m] * twiddle(k);
+            GpuComplex<Real> const y2 = out[k+2*m] * twiddle(2*k);
+            GpuComplex<Real> const y3 = out[k+3*m] * twiddle(3*k);
+            GpuComplex<Real> const y4 = out[k+4*m] * twiddle(4*k);
+            GpuComplex<Real> const t1 = y1 + y4;
+            GpuComplex<Real> const t2 = y2 + y3;
+            GpuComplex<Real> const t3 = y1 - y4;
+            GpuComplex<Real> const t4 = y2 - y3;
+            GpuComplex<Real> const a1 = y0 + c1*t1 + c2*t2;
+            GpuComplex<Real> const a2 = y0 + c2*t1 + c1*t2;
+            GpuComplex<Real> const b1 = mul_mi(s1*t3 + s2*t4, is_forward);
+            GpuComplex<Real> const b2 = mul_mi(s2*t3 - s1*t4, is_forward);
+            out[k    ] = y0 + t1 + t2;
+            out[k+  m] = a1 + b1;
+            out[k+2*m] = a2 + b2;
+            out[k+3*m] = a2 - b2;
+            out[k+4*m] = a1 - b1;
+        }
+    } else {
+        // exp(-+2 pi i x/p) is twiddle(x*m)
+        Vector<GpuComplex<Real> > y(p);
+        for (int k = 0; k < m; ++k) {
+            y[0] = out[k];
+            for (int q = 1; q < p; ++q) {
+                y[q] = out[k+q*m] * twiddle(q*k);
+            }
+            for (int s = 0; s < p; ++s) {
+                GpuComplex<Real> x = y[0];
+                for (int q = 1; q < p; ++q) {
+                    x += y[q] * twiddle(((q*s) % p) * m);
+                }
+                out[k+s*m] = x;
+            }
+        }
+    }
+}
+
+PlanR2C1D::PlanR2C1D (int n)
+    : m_n(n),
+      m_plan((n % 2 == 0) ? n/2 : n)
+{
+    if (n % 2 == 0) {
+        m_twiddle.resize(n/2+1);
+        for (int k = 0; k <= n/2; ++k) {
+            m_twiddle[k] = unit_root(k, n);
+        }
+    }
+}
+
+void PlanR2C1D::forward (Real const* in, GpuComplex<Real>* out,
+                         GpuComplex<Real>* work) const noexcept
+{
+    if (m_n % 2 == 0) {
+        // The even and odd points are the real and imaginary parts of a
+        // complex sequence of length h, whose transform z is split into the
+        // transforms of the even and odd points.
+        int const h = m_n/2;
+        GpuComplex<Real>* zin = work;
+        GpuComplex<Real>* z = work + h;
+        for (int j = 0; j < h; ++j) {
+            zin[j] = GpuComplex<Real>(in[2*j], in[2*j+1]);
+        }
+        m_plan.forward(zin, z);
+        for (int k = 0; k <= h; ++k) {
+            GpuComplex<Real> const zk = z[k % h];
+            GpuComplex<Real> const zc = conj(z[(h-k) % h]);
+            GpuComplex<Real> const even = Real(0.5)*(zk + zc);
+            GpuComplex<Real> const odd = Real(0.5)*mul_mi(zk - zc, true);
+            out[k] = even + m_twiddle[k]*odd;
+        }
+    } else {
+        GpuComplex<Real>* zin = work;
+        GpuComplex<Real>* z = work + m_n;
+        for (int j = 0; j < m_n; ++j) {
+            zin[j] = GpuComplex<Real>(in[j], Real(0.));
+        }
+        m_plan.forward(zin, z);
+        for (int k = 0; k <= m_n/2; ++k) {
+            out[k] = z[k];
+        }
+    }
+}
+
+void PlanR2C1D::backward (GpuComplex<Real> const* in, Real* out,
+                          GpuComplex<Real>* work) const noexcept
+{
+    if (m_n % 2 == 0) {
+        int const h = m_n/2;
+        GpuComplex<Real>* zin = work;
+        GpuComplex<Real>* z = work + h;
+        for (int k = 0; k < h; ++k) {
+            GpuComplex<Real> const xc = conj(in[h-k]);
+            GpuComplex<Real> const even = in[k] + xc;
+            GpuComplex<Real> const odd = (in[k] - xc) * conj(m_twiddle[k]);
+            zin[k] = even + mul_mi(odd, false);
+        }
+        m_plan.backward(zin, z);
+        for (int j = 0; j < h; ++j) {
+            out[2*j  ] = z[j].real();
+            out[2*j+1] = z[j].imag();
+        }
+    } else {
+        GpuComplex<Real>* zin = work;
+        GpuComplex<Real>* z = work + m_n;
+        zin[0] = in[0];
+        for (int k = 1; k <= m_n/2; ++k) {
+            zin[k] = in[k];
+            zin[m_n-k] = conj(in[k]);
+        }
+        m_plan.backward(zin, z);
+        for (int j = 0; j < m_n; ++j) {
+            out[j] = z[j].real();
+        }
+    }
+}
+
+BoxArray makePencils (Box const& domain, int dir, int npencils)
+{
+    IntVect const len = domain.length();
+    IntVect nsplit(1);
+#if (AMREX_SPACEDIM == 2)
+    nsplit[1-dir] = std::max(1, std::min(npencils, len[1-dir]));
+#elif (AMREX_SPACEDIM == 3)
+    // The most pencils, and then the most square cross sections
+    int const d1 = (dir == 0) ? 1 : 0;
+    int const d2 = (dir == 2) ? 1 : 2;
+    Real best_aspect = std::numeric_limits<Real>::max();
+    for (int n1 = 1; n1 <= std::min(npencils, len[d1]); ++n1) {
+        int const n2 = std::min(npencils/n1, len[d2]);
+        Real const w1 = Real(len[d1])/Real(n1);
+        Real const w2 = Real(len[d2])/Real(n2);
+        Real const aspect = std::max(w1,w2)/std::min(w1,w2);
+        if (n1*n2 > nsplit[d1]*nsplit[d2] ||
+            (n1*n2 == nsplit[d1]*nsplit[d2] && aspect < best_aspect)) {
+            nsplit[d1] = n1;
+            nsplit[d2] = n2;
+            best_aspect = aspect;
+        }
+    }
+#else
+    amrex::ignore_unused(dir,npencils);
+#endif
+
+    BoxList bl;
+    amrex::LoopOnCpu(Box(IntVect(0), nsplit-1), [&] (int i, int j, int k)
+    {
+        IntVect const iv(AMREX_D_DECL(i,j,k));
+        IntVect lo, hi;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            lo[idim] = domain.smallEnd(idim) + (len[idim]*iv[idim])/nsplit[idim];
+            hi[idim] = domain.smallEnd(idim) + (len[idim]*(iv[idim]+1))/nsplit[idim] - 1;
+        }
+        bl.push_back(Box(lo,hi));
+    });
+    return BoxArray(std::move(bl));
+}
+
+R2C::R2C (Box const& domain, int npencils)
+    : m_real_domain(domain),
+      m_plan_r2c(domain.length(0))
+{
+    if (npencils <= 0) {
+        npencils = ParallelDescriptor::NProcs();
+    }
+
+    IntVect shi = domain.length() - 1;
+    shi[0] = domain.length(0)/2;
+    m_spectral_domain = Box(IntVect(0), shi);
+
+    // The pencils are in pinned memory, because the 1D transforms are on
+    // the CPU.
+    MFInfo const info = MFInfo().SetArena(The_Pinned_Arena());
+
+    BoxArray const rba = makePencils(m_real_domain, 0, npencils);
+    DistributionMapping const rdm = make_pencil_dm(rba);
+    m_rdata.define(rba, rdm, 1, 0, info);
+
+    // The pencils in the first direction of the spectral data have the same
+    // cross sections as those of the real data.
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        BoxArray const cba = makePencils(m_spectral_domain, idim, npencils);
+        m_cdata[idim].define(cba, (idim == 0) ? rdm : make_pencil_dm(cba), 1, 0, info);
+        if (idim > 0) {
+            m_plan[idim] = Plan1D(m_spectral_domain.length(idim));
+        }
+    }
+}
+
+void R2C::forward (MultiFab const& mf)
+{
+    BL_PROFILE("FFT::R2C::forward()");
+
+    m_rdata.setVal(0._rt);
+    m_rdata.ParallelCopy(mf, 0, 0, 1);
+    Gpu::streamSynchronize();
+
+    int const nx = m_real_domain.length(0);
+    int const nxc = m_spectral_domain.length(0);
+    IntVect const shift = -m_real_domain.smallEnd();
+    for (MFIter mfi(m_rdata); mfi.isValid(); ++mfi) {
+        Box const& bx = mfi.validbox();
+        auto const& r = m_rdata.const_array(mfi);
+        auto const& c = m_cdata[0].array(mfi);
+        Box cross_section = bx;
+        cross_section.setBig(0, bx.smallEnd(0));
+        Long const nlines = cross_section.numPts();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        {
+            Vector<Real> in(nx);
+            Vector<GpuComplex<Real> > out(nxc);
+            Vector<GpuComplex<Real> > work(m_plan_r2c.workSize());
+#ifdef AMREX_USE_OMP
+#pragma omp for
+#endif
+            for (Long iline = 0; iline < nlines; ++iline) {
+                IntVect iv = cross_section.atOffset(iline);
+                for (int m = 0; m < nx; ++m) {
+                    iv[0] = bx.smallEnd(0) + m;
+                    in[m] = r(iv);
+                }
+                m_plan_r2c.forward(in.data(), out.data(), work.data());
+                iv += shift;
+                for (int m = 0; m < nxc; ++m) {
+                    iv[0] = m;
+                    c(iv) = out[m];
+                }
+            }
+        }
+    }
+
+    for (int idim = 1; idim < AMREX_SPACEDIM; ++idim) {
+        m_cdata[idim].ParallelCopy(m_cdata[idim-1]);
+        Gpu::streamSynchronize();
+        transform_lines(m_cdata[idim], idim, m_plan[idim], true);
+    }
+}
+
+void R2C::backward (MultiFab& mf)
+{
+    BL_PROFILE("FFT::R2C::backward()");
+
+    for (int idim = AMREX_SPACEDIM-1; idim > 0; --idim) {
+        transform_lines(m_cdata[idim], idim, m_plan[idim], false);
+        m_cdata[idim-1].ParallelCopy(m_cdata[idim]);
+        Gpu::streamSynchronize();
+    }
+
+    int const nx = m_real_domain.length(0);
+    int const nxc = m_spectral_domain.length(0);
+    IntVect const shift = -m_real_domain.smallEnd();
+    for (MFIter mfi(m_rdata); mfi.isValid(); ++mfi) {
+        Box const& bx = mfi.validbox();
+        auto const& r = m_rdata.array(mfi);
+        auto const& c = m_cdata[0].const_array(mfi);
+        Box cross_section = bx;
+        cross_section.setBig(0, bx.smallEnd(0));
+        Long const nlines = cross_section.numPts();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        {
+            Vector<GpuComplex<Real> > in(nxc);
+            Vector<Real> out(nx);
+            Vector<GpuComplex<Real> > work(m_plan_r2c.workSize());
+#ifdef AMREX_USE_OMP
+#pragma omp for
+#endif
+            for (Long iline = 0; iline < nlines; ++iline) {
+                IntVect iv = cross_section.atOffset(iline);
+                IntVect civ = iv + shift;
+                for (int m = 0; m < nxc; ++m) {
+                    civ[0] = m;
+                    in[m] = c(civ);
+                }
+                m_plan_r2c.backward(in.data(), out.data(), work.data());
+                for (int m = 0; m < nx; ++m) {
+                    iv[0] = bx.smallEnd(0) + m;
+                    r(iv) = out[m];
+                }
+            }
+        }
+    }
+
+    mf.ParallelCopy(m_rdata, 0, 0, 1);
+}
+
+}}
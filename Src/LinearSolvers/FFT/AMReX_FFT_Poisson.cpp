@@ -0,0 +1,168 @@
+#include <AMReX_FFT_Poisson.H>
+#include <AMReX_Loop.H>
+
+#include <algorithm>
+#include <cmath>
+
+namespace amrex { namespace FFT {
+
+Poisson::Poisson (Geometry const& geom, int npencils)
+    : m_geom(geom),
+      m_r2c(geom.Domain(), npencils)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_geom.isAllPeriodic(),
+                                     "FFT::Poisson: the domain must be periodic");
+}
+
+void Poisson::solve (MultiFab& soln, MultiFab const& rhs)
+{
+    BL_PROFILE("FFT::Poisson::solve()");
+
+    // Eigenvalues of the 1D second differences
+    constexpr Real twopi = Real(6.283185307179586476925286766559);
+    Box const& sdomain = m_r2c.spectralDomain();
+    IntVect const n = m_geom.Domain().length();
+    auto const dxinv = m_geom.InvCellSizeArray();
+    Array<Vector<Real>,AMREX_SPACEDIM> lambda;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        lambda[idim].resize(sdomain.length(idim));
+        for (int k = 0; k < sdomain.length(idim); ++k) {
+            lambda[idim][k] = Real(2.)*dxinv[idim]*dxinv[idim]
+                * (std::cos(twopi*Real(k)/Real(n[idim])) - Real(1.));
+        }
+    }
+
+    // The backward transform is not normalized.
+    Real const scale = Real(1.) / m_geom.Domain().d_numPts();
+    m_r2c.forwardThenBackward(rhs, soln,
+        [&] (int i, int j, int k, GpuComplex<Real>& spectral_data)
+        {
+            amrex::ignore_unused(j,k);
+            Real const lap = AMREX_D_TERM(lambda[0][i], + lambda[1][j], + lambda[2][k]);
+            if (lap == Real(0.)) {
+                spectral_data = GpuComplex<Real>(Real(0.), Real(0.));
+            } else {
+                spectral_data *= scale/lap;
+            }
+        });
+}
+
+#if (AMREX_SPACEDIM == 3)
+
+namespace {
+
+Box doubled_domain (Box const& domain)
+{
+    return Box(domain.smallEnd(), domain.bigEnd() + domain.length());
+}
+
+// Average of 1/r over a cell of size a x b x c centered at r = 0
+Real cell_average_inverse_distance (Real a, Real b, Real c)
+{
+    // Antiderivative of 1/r in x, y and z
+    auto F = [] (double x, double y, double z) -> double
+    {
+        double const r = std::sqrt(x*x+y*y+z*z);
+        if (r == 0.0) { return 0.0; }
+        double f = 0.0;
+        if (y*z != 0.0) { f += y*z*std::log(x+r) - 0.5*x*x*std::atan(y*z/(x*r)); }
+        if (x*z != 0.0) { f += x*z*std::log(y+r) - 0.5*y*y*std::atan(x*z/(y*r)); }
+        if (x*y != 0.0) { f += x*y*std::log(z+r) - 0.5*z*z*std::atan(x*y/(z*r)); }
+        return f;
+    };
+    // Integral over [0,a/2] x [0,b/2] x [0,c/2], which is an eighth of the cell
+    double const ha = 0.5*a, hb = 0.5*b, hc = 0.5*c;
+    double integral = 0.0;
+    for (int k = 0; k < 2; ++k) {
+    for (int j = 0; j < 2; ++j) {
+    for (int i = 0; i < 2; ++i) {
+        double const sign = ((i+j+k) % 2 == 1) ? 1.0 : -1.0;
+        integral += sign * F(i*ha, j*hb, k*hc);
+    }}}
+    return static_cast<Real>(8.0*integral/(double(a)*double(b)*double(c)));
+}
+
+}
+
+PoissonOpenBC::PoissonOpenBC (Geometry const& geom, int npencils)
+    : m_geom(geom),
+      m_r2c(doubled_domain(geom.Domain()), npencils)
+{
+    BL_PROFILE("FFT::PoissonOpenBC::define()");
+
+    // Green's function on the doubled domain, periodically extended, so
+    // that its circular convolution with rhs is the free-space convolution
+    // in the domain.
+    constexpr Real oneover4pi = Real(1.)/Real(4.*3.1415926535897932);
+    auto const dx = m_geom.CellSizeArray();
+    Real const g0 = -oneover4pi * cell_average_inverse_distance(dx[0],dx[1],dx[2]);
+    Box const& ddomain = m_r2c.realDomain();
+    auto const lo = ddomain.smallEnd().dim3();
+    auto const len = ddomain.length3d();
+
+    BoxArray gba(ddomain);
+    gba.maxSize(64);
+    DistributionMapping gdm(gba);
+    MultiFab green(gba, gdm, 1, 0);
+    for (MFIter mfi(green); mfi.isValid(); ++mfi) {
+        auto const& g = green.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            int ii = i - lo.x;
+            int jj = j - lo.y;
+            int kk = k - lo.z;
+            ii = amrex::min(ii, len[0]-ii);
+            jj = amrex::min(jj, len[1]-jj);
+            kk = amrex::min(kk, len[2]-kk);
+            if (ii == 0 && jj == 0 && kk == 0) {
+                g(i,j,k) = g0;
+            } else {
+                Real const x = ii*dx[0];
+                Real const y = jj*dx[1];
+                Real const z = kk*dx[2];
+                g(i,j,k) = -oneover4pi / std::sqrt(x*x+y*y+z*z);
+            }
+        });
+    }
+
+    m_r2c.forward(green);
+
+    // The Green's function is even, so its transform is real.  It includes
+    // the cell volume of the convolution and the normalization of the
+    // backward transform.
+    cMultiFab const& spectral = m_r2c.spectralData();
+    m_green.define(spectral.boxArray(), spectral.DistributionMap(), 1, 0,
+                   MFInfo().SetArena(The_Pinned_Arena()));
+    Real const fac = AMREX_D_TERM(dx[0],*dx[1],*dx[2]) / ddomain.d_numPts();
+    for (MFIter mfi(m_green); mfi.isValid(); ++mfi) {
+        auto const& g = m_green.array(mfi);
+        auto const& s = spectral.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            g(i,j,k) = s(i,j,k).real() * fac;
+        });
+    }
+}
+
+void PoissonOpenBC::solve (MultiFab& soln, MultiFab const& rhs)
+{
+    BL_PROFILE("FFT::PoissonOpenBC::solve()");
+
+    m_r2c.forward(rhs);
+
+    cMultiFab& spectral = m_r2c.spectralData();
+    for (MFIter mfi(spectral); mfi.isValid(); ++mfi) {
+        auto const& s = spectral.array(mfi);
+        auto const& g = m_green.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            s(i,j,k) *= g(i,j,k);
+        });
+    }
+
+    m_r2c.backward(soln);
+}
+
+#endif
+
+}}
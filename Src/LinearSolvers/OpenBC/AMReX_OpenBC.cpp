@@ -2,6 +2,10 @@
 #include <AMReX_OpenBC_K.H>
 #include <AMReX_Algorithm.H>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace amrex
 {
 
@@ -206,6 +210,18 @@ void OpenBCSolver::useHypre (bool use_hypre) noexcept
     }
 }
 
+void OpenBCSolver::setMultipoleOrder (int order) noexcept
+{
+    AMREX_ALWAYS_ASSERT(order >= 0 && order <= openbc::M);
+    m_multipole_order = order;
+}
+
+void OpenBCSolver::setOpeningAngle (Real theta) noexcept
+{
+    AMREX_ALWAYS_ASSERT(theta < 1._rt);
+    m_opening_angle = theta;
+}
+
 Real OpenBCSolver::solve (const Vector<MultiFab*>& a_sol,
                           const Vector<MultiFab const*>& a_rhs,
                           Real a_tol_rel, Real a_tol_abs)
@@ -259,9 +275,14 @@ Real OpenBCSolver::solve (const Vector<MultiFab*>& a_sol,
     }
 
     {
+        auto potential_start_time = amrex::second();
         Gpu::DeviceVector<openbc::Moments> moments(m_nblocks_local);
         compute_moments(moments);
         compute_potential(moments);
+        if (m_verbose >= 1) {
+            amrex::Print() << "OpenBCSolver boundary potential time = "
+                           << amrex::second() - potential_start_time << "\n";
+        }
     }
 
     MultiFab rhsg(m_bag, m_phind.DistributionMap(), 1, a_rhs[0]->nGrowVect());
@@ -335,10 +356,6 @@ Real OpenBCSolver::solve (const Vector<MultiFab*>& a_sol,
                                  {AMREX_D_DECL(LinOpBCType::Dirichlet,
                                                LinOpBCType::Dirichlet,
                                                LinOpBCType::Dirichlet)});
-        m_poisson_2->setLevelBC(0, &sol_all[0]);
-        for (int ilev = 1; ilev < nlevels; ++ilev) {
-            m_poisson_2->setLevelBC(ilev, nullptr);
-        }
 
         m_mlmg_2 = std::make_unique<MLMG>(*m_poisson_2);
         m_mlmg_2->setVerbose(m_verbose);
@@ -351,6 +368,12 @@ Real OpenBCSolver::solve (const Vector<MultiFab*>& a_sol,
 #endif
     }
 
+    // The boundary values are those of this solve's potential.
+    m_poisson_2->setLevelBC(0, &sol_all[0]);
+    for (int ilev = 1; ilev < nlevels; ++ilev) {
+        m_poisson_2->setLevelBC(ilev, nullptr);
+    }
+
     Real err = m_mlmg_2->solve(GetVecOfPtrs(sol_all), GetVecOfConstPtrs(rhs_all),
                                a_tol_rel, a_tol_abs);
 
@@ -665,10 +688,14 @@ void OpenBCSolver::compute_moments (Gpu::DeviceVector<openbc::Moments>& moments)
     }
 #endif
 
+    if (m_opening_angle > 0._rt) {
+        exchange_tree_moments(moments);
+    } else {
 #ifdef AMREX_USE_MPI
-    bcast_moments(moments);
+        bcast_moments(moments);
 #endif
-    m_nblocks = moments.size();
+        m_nblocks = moments.size();
+    }
 }
 
 #ifdef AMREX_USE_MPI
@@ -725,6 +752,286 @@ void OpenBCSolver::bcast_moments (Gpu::DeviceVector<openbc::Moments>& moments)
 }
 #endif
 
+namespace {
+
+// Index of the moment of u^p v^q/(p! q!) in openbc::Moments::mom
+constexpr int mom_index (int p, int q) noexcept
+{
+    return q*(openbc::M+1) - q*(q-1)/2 + p;
+}
+
+// The two coordinates of the center of the moments in the plane of the face
+void face_coords (openbc::Moments const& mom, Real& u, Real& v) noexcept
+{
+    if (mom.face.coordDir() == 0) {
+        u = mom.y;
+        v = mom.z;
+    } else if (mom.face.coordDir() == 1) {
+        u = mom.x;
+        v = mom.z;
+    } else {
+        u = mom.x;
+        v = mom.y;
+    }
+}
+
+// Add the moments of src, translated to the center of dst, to dst.  The
+// translation is exact.
+void add_shifted_moments (openbc::Moments const& src, openbc::Moments& dst) noexcept
+{
+    Real us, vs, ud, vd;
+    face_coords(src, us, vs);
+    face_coords(dst, ud, vd);
+    // du^n/n! and dv^n/n!
+    Real upow[openbc::M+1], vpow[openbc::M+1];
+    upow[0] = vpow[0] = 1._rt;
+    for (int n = 1; n <= openbc::M; ++n) {
+        upow[n] = upow[n-1]*(us-ud)/Real(n);
+        vpow[n] = vpow[n-1]*(vs-vd)/Real(n);
+    }
+    for (int q = 0; q <= openbc::M; ++q) {
+        for (int p = 0; p <= openbc::M-q; ++p) {
+            Real m = 0._rt;
+            for (int b = 0; b <= q; ++b) {
+                for (int a = 0; a <= p; ++a) {
+                    m += src.mom[mom_index(a,b)] * upow[p-a] * vpow[q-b];
+                }
+            }
+            dst.mom[mom_index(p,q)] += m;
+        }
+    }
+}
+
+// Quadtree over the blocks of a face box.  Level 0 is the blocks, and a
+// node on level l is the union of up to 2^l x 2^l blocks.
+struct FaceTree
+{
+    struct Level {
+        int n1, n2;
+        Vector<openbc::Moments> mom;
+        Vector<Real> radius;
+    };
+    Vector<Level> levels;
+};
+
+}
+
+void OpenBCSolver::exchange_tree_moments (Gpu::DeviceVector<openbc::Moments>& moments)
+{
+    BL_PROFILE("OpenBCSolver::tree_mom()");
+
+    auto const problo = m_geom[0].ProbLoArray();
+    auto const dx     = m_geom[0].CellSizeArray();
+    int const crse_ratio = m_coarsen_ratio;
+
+#ifdef AMREX_USE_GPU
+    Gpu::PinnedVector<openbc::Moments> h_moments(moments.size());
+    Gpu::copyAsync(Gpu::deviceToHost, moments.begin(), moments.end(),
+                   h_moments.begin());
+    Gpu::streamSynchronize();
+#else
+    auto const& h_moments = moments;
+#endif
+
+    // Build the trees of the local face boxes from the moments of the blocks.
+    Vector<FaceTree> trees(m_momtags_h.size());
+    for (int itag = 0, ntags = m_momtags_h.size(); itag < ntags; ++itag) {
+        auto const& tag = m_momtags_h[itag];
+        int const d1 = (tag.face.coordDir() == 0) ? 1 : 0;
+        int const d2 = (tag.face.coordDir() == 2) ? 1 : 2;
+        int const nb1 = tag.b2d.length(d1) / crse_ratio;
+        int const nb2 = tag.b2d.length(d2) / crse_ratio;
+        Real const bw1 = crse_ratio*dx[d1];
+        Real const bw2 = crse_ratio*dx[d2];
+
+        auto& levels = trees[itag].levels;
+        levels.emplace_back();
+        levels[0].n1 = nb1;
+        levels[0].n2 = nb2;
+        levels[0].mom.assign(h_moments.begin()+tag.offset,
+                             h_moments.begin()+tag.offset+nb1*nb2);
+        levels[0].radius.assign(nb1*nb2, Real(0.5)*std::sqrt(bw1*bw1+bw2*bw2));
+
+        for (int bsize = 2; levels.back().n1 > 1 || levels.back().n2 > 1; bsize *= 2) {
+            auto const& fine = levels.back();
+            FaceTree::Level crse;
+            crse.n1 = (fine.n1+1)/2;
+            crse.n2 = (fine.n2+1)/2;
+            crse.mom.resize(crse.n1*crse.n2);
+            crse.radius.resize(crse.n1*crse.n2);
+            for (int j = 0; j < crse.n2; ++j) {
+            for (int i = 0; i < crse.n1; ++i) {
+                // Blocks [ilo,ihi) x [jlo,jhi) of the box
+                int const ilo = i*bsize, ihi = std::min(ilo+bsize, nb1);
+                int const jlo = j*bsize, jhi = std::min(jlo+bsize, nb2);
+                auto& mom = crse.mom[i+j*crse.n1];
+                mom = fine.mom[2*i+2*j*fine.n1];
+                Real const uc = problo[d1] + dx[d1]*(tag.b2d.smallEnd(d1)
+                                                     + crse_ratio*Real(0.5)*(ilo+ihi));
+                Real const vc = problo[d2] + dx[d2]*(tag.b2d.smallEnd(d2)
+                                                     + crse_ratio*Real(0.5)*(jlo+jhi));
+                if (d1 == 0) {
+                    mom.x = uc;
+                    if (d2 == 1) { mom.y = vc; } else { mom.z = vc; }
+                } else {
+                    mom.y = uc;
+                    mom.z = vc;
+                }
+                for (auto& m : mom.mom) {
+                    m = 0._rt;
+                }
+                for (int jj = 2*j; jj < std::min(2*j+2, fine.n2); ++jj) {
+                for (int ii = 2*i; ii < std::min(2*i+2, fine.n1); ++ii) {
+                    add_shifted_moments(fine.mom[ii+jj*fine.n1], mom);
+                }}
+                Real const w1 = (ihi-ilo)*bw1;
+                Real const w2 = (jhi-jlo)*bw2;
+                crse.radius[i+j*crse.n1] = Real(0.5)*std::sqrt(w1*w1+w2*w2);
+            }}
+            levels.push_back(std::move(crse));
+        }
+    }
+
+    // For each box of boundary points, the nodes of the local trees that are
+    // far enough from all the points of the box, or the blocks.
+    int const nprocs = ParallelContext::NProcsSub();
+    BoxArray const& tba = m_crse_grown_faces_phi.boxArray();
+    DistributionMapping const& tdm = m_crse_grown_faces_phi.DistributionMap();
+    Real const theta = m_opening_angle;
+    Vector<Vector<openbc::Moments>> send_moments(nprocs);
+    Vector<Vector<int>> send_counts(nprocs);
+    Vector<std::array<int,3>> stack;
+    for (int ibox = 0, nboxes = tba.size(); ibox < nboxes; ++ibox) {
+        Box const& tbox = tba[ibox];
+        Real tlo[AMREX_SPACEDIM], thi[AMREX_SPACEDIM];
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            tlo[idim] = problo[idim] + tbox.smallEnd(idim)*crse_ratio*dx[idim];
+            thi[idim] = problo[idim] + tbox.bigEnd(idim)*crse_ratio*dx[idim];
+        }
+        int const dest = ParallelContext::global_to_local_rank(tdm[ibox]);
+        auto& to_send = send_moments[dest];
+        int const count_before = to_send.size();
+        for (auto const& tree : trees) {
+            stack.push_back({static_cast<int>(tree.levels.size())-1, 0, 0});
+            while (!stack.empty()) {
+                int const ilev = stack.back()[0];
+                int const i    = stack.back()[1];
+                int const j    = stack.back()[2];
+                stack.pop_back();
+                auto const& level = tree.levels[ilev];
+                auto const& mom = level.mom[i+j*level.n1];
+                Real const c[] = {mom.x, mom.y, mom.z};
+                Real dist2 = 0._rt;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    Real const d = std::max({tlo[idim]-c[idim], c[idim]-thi[idim], 0._rt});
+                    dist2 += d*d;
+                }
+                Real const r = level.radius[i+j*level.n1];
+                if (ilev == 0 || r*r < theta*theta*dist2) {
+                    to_send.push_back(mom);
+                } else {
+                    auto const& fine = tree.levels[ilev-1];
+                    for (int jj = 2*j; jj < std::min(2*j+2, fine.n2); ++jj) {
+                    for (int ii = 2*i; ii < std::min(2*i+2, fine.n1); ++ii) {
+                        stack.push_back({ilev-1, ii, jj});
+                    }}
+                }
+            }
+        }
+        send_counts[dest].push_back(static_cast<int>(to_send.size()) - count_before);
+    }
+
+    // Each process receives the lists for its boxes from all processes.
+    int const myproc = ParallelContext::MyProcSub();
+    int const nlocal = m_crse_grown_faces_phi.local_size();
+    Vector<openbc::Moments> recv_moments;
+    Vector<int> recv_counts; // number of moments from each process for each local box
+    Vector<int> recv_offset(nprocs+1, 0); // start of the moments from each process
+#ifdef AMREX_USE_MPI
+    if (nprocs > 1)
+    {
+        MPI_Comm comm = ParallelContext::CommunicatorSub();
+        Vector<int> scount(nprocs), rcount(nprocs), sdispl(nprocs), rdispl(nprocs);
+        Vector<openbc::Moments> sbuf;
+        Vector<int> scbuf;
+        for (int iproc = 0; iproc < nprocs; ++iproc) {
+            scount[iproc] = send_moments[iproc].size();
+            sbuf.insert(sbuf.end(), send_moments[iproc].begin(), send_moments[iproc].end());
+            scbuf.insert(scbuf.end(), send_counts[iproc].begin(), send_counts[iproc].end());
+        }
+        MPI_Alltoall(scount.data(), 1, MPI_INT, rcount.data(), 1, MPI_INT, comm);
+
+        Long sbytes = 0, rbytes = 0;
+        for (int iproc = 0; iproc < nprocs; ++iproc) {
+            recv_offset[iproc+1] = recv_offset[iproc] + rcount[iproc];
+            sdispl[iproc] = static_cast<int>(sbytes);
+            rdispl[iproc] = static_cast<int>(rbytes);
+            sbytes += static_cast<Long>(scount[iproc])*sizeof(openbc::Moments);
+            rbytes += static_cast<Long>(rcount[iproc])*sizeof(openbc::Moments);
+            if (sbytes > static_cast<Long>(std::numeric_limits<int>::max()) ||
+                rbytes > static_cast<Long>(std::numeric_limits<int>::max())) {
+                amrex::Abort("OpenBC: integer overflow. Let us know and we will fix this.");
+            }
+            scount[iproc] *= static_cast<int>(sizeof(openbc::Moments));
+            rcount[iproc] *= static_cast<int>(sizeof(openbc::Moments));
+        }
+        recv_moments.resize(recv_offset[nprocs]);
+        MPI_Alltoallv(sbuf.data(), scount.data(), sdispl.data(), MPI_CHAR,
+                      recv_moments.data(), rcount.data(), rdispl.data(), MPI_CHAR, comm);
+
+        for (int iproc = 0; iproc < nprocs; ++iproc) {
+            scount[iproc] = send_counts[iproc].size();
+            sdispl[iproc] = (iproc == 0) ? 0 : sdispl[iproc-1] + scount[iproc-1];
+            rcount[iproc] = nlocal;
+            rdispl[iproc] = iproc*nlocal;
+        }
+        recv_counts.resize(nprocs*nlocal);
+        MPI_Alltoallv(scbuf.data(), scount.data(), sdispl.data(), MPI_INT,
+                      recv_counts.data(), rcount.data(), rdispl.data(), MPI_INT, comm);
+    }
+    else
+#endif
+    {
+        recv_moments = std::move(send_moments[myproc]);
+        recv_counts = std::move(send_counts[myproc]);
+        recv_offset[1] = recv_moments.size();
+    }
+
+    // Sort the moments by box
+    m_tree_offset.assign(nlocal+1, 0);
+    for (int li = 0; li < nlocal; ++li) {
+        m_tree_offset[li+1] = m_tree_offset[li];
+        for (int iproc = 0; iproc < nprocs; ++iproc) {
+            m_tree_offset[li+1] += recv_counts[iproc*nlocal+li];
+        }
+    }
+
+#ifdef AMREX_USE_GPU
+    Gpu::PinnedVector<openbc::Moments> h_moments_tree(m_tree_offset[nlocal]);
+#else
+    Gpu::DeviceVector<openbc::Moments> h_moments_tree(m_tree_offset[nlocal]);
+#endif
+    Vector<int> pos(m_tree_offset.begin(), m_tree_offset.end()-1);
+    for (int iproc = 0; iproc < nprocs; ++iproc) {
+        auto src = recv_moments.begin() + recv_offset[iproc];
+        for (int li = 0; li < nlocal; ++li) {
+            int const n = recv_counts[iproc*nlocal+li];
+            std::copy(src, src+n, h_moments_tree.begin()+pos[li]);
+            src += n;
+            pos[li] += n;
+        }
+    }
+
+#ifdef AMREX_USE_GPU
+    moments.resize(h_moments_tree.size());
+    Gpu::copyAsync(Gpu::hostToDevice, h_moments_tree.begin(), h_moments_tree.end(),
+                   moments.begin());
+    Gpu::streamSynchronize();
+#else
+    std::swap(moments, h_moments_tree);
+#endif
+}
+
 void OpenBCSolver::compute_potential (Gpu::DeviceVector<openbc::Moments> const& moments)
 {
     BL_PROFILE("OpenBCSolver::comp_phi()");
@@ -733,10 +1040,16 @@ void OpenBCSolver::compute_potential (Gpu::DeviceVector<openbc::Moments> const&
     auto const dx     = m_geom[0].CellSizeArray();
 
     int crse_ratio = m_coarsen_ratio;
-    int nblocks = m_nblocks;
-    openbc::Moments const* pmom = moments.data();
+    int order = m_multipole_order;
+    bool use_tree = m_opening_angle > 0._rt;
     for (MFIter mfi(m_crse_grown_faces_phi); mfi.isValid(); ++mfi) {
         Box const& b = mfi.validbox();
+        openbc::Moments const* pmom = moments.data();
+        int nblocks = m_nblocks;
+        if (use_tree) {
+            pmom += m_tree_offset[mfi.LocalIndex()];
+            nblocks = m_tree_offset[mfi.LocalIndex()+1] - m_tree_offset[mfi.LocalIndex()];
+        }
         Array4<Real> const& phi_arr = m_crse_grown_faces_phi.array(mfi);
 #if defined(AMREX_USE_GPU)
         const auto lo  = amrex::lbound(b);
@@ -744,7 +1057,7 @@ void OpenBCSolver::compute_potential (Gpu::DeviceVector<openbc::Moments> const&
         const auto lenxy = len.x*len.y;
         const auto lenx = len.x;
 #ifdef AMREX_USE_DPCPP
-        amrex::ignore_unused(problo,dx,crse_ratio,nblocks,pmom,b,phi_arr,lo,
+        amrex::ignore_unused(problo,dx,crse_ratio,order,nblocks,pmom,b,phi_arr,lo,
                              lenxy,lenx);
         amrex::Abort("xxxxx DPCPP todo: openbc compute_potential");
 #else
@@ -763,7 +1076,7 @@ void OpenBCSolver::compute_potential (Gpu::DeviceVector<openbc::Moments> const&
             Real zb = problo[2] + k*crse_ratio*dx[2];
             Real phi = Real(0.);
             for (int iblock = threadIdx.x; iblock < nblocks; iblock += blockDim.x) {
-                phi += openbc::block_potential(pmom[iblock], xb, yb, zb);
+                phi += openbc::block_potential(pmom[iblock], xb, yb, zb, order);
             }
             Real phitot = Gpu::blockReduceSum<AMREX_GPU_MAX_THREADS>(phi);
             if (threadIdx.x == 0) {
@@ -779,7 +1092,7 @@ void OpenBCSolver::compute_potential (Gpu::DeviceVector<openbc::Moments> const&
             Real zb = problo[2] + k*crse_ratio*dx[2];
             Real phi = 0._rt;
             for (int iblock = 0; iblock < nblocks; ++iblock) {
-                phi += openbc::block_potential(pmom[iblock], xb, yb, zb);
+                phi += openbc::block_potential(pmom[iblock], xb, yb, zb, order);
             }
             phi_arr(i,j,k) = phi;
         });
@@ -79,6 +79,36 @@ ParticleContainerBase::defineBufferMap () const
     }
 }
 
+Vector<int>
+ParticleContainerBase::NeighborProcs (int ngrow) const
+{
+    const int num_levs = finestLevel() + 1;
+    bool valid = (ngrow == m_neighbor_procs_cache_ngrow) &&
+                 (num_levs == static_cast<int>(m_neighbor_procs_cache_ba.size()));
+    for (int lev = 0; valid && lev < num_levs; ++lev)
+    {
+        valid = BoxArray::SameRefs(ParticleBoxArray(lev), m_neighbor_procs_cache_ba[lev]) &&
+            DistributionMapping::SameRefs(ParticleDistributionMap(lev),
+                                          m_neighbor_procs_cache_dm[lev]);
+    }
+
+    if (! valid)
+    {
+        BL_PROFILE("ParticleContainer::NeighborProcs");
+        m_neighbor_procs_cache = computeNeighborProcs(GetParGDB(), ngrow);
+        m_neighbor_procs_cache_ngrow = ngrow;
+        m_neighbor_procs_cache_ba.resize(num_levs);
+        m_neighbor_procs_cache_dm.resize(num_levs);
+        for (int lev = 0; lev < num_levs; ++lev)
+        {
+            m_neighbor_procs_cache_ba[lev] = ParticleBoxArray(lev);
+            m_neighbor_procs_cache_dm[lev] = ParticleDistributionMap(lev);
+        }
+    }
+
+    return m_neighbor_procs_cache;
+}
+
 void ParticleContainerBase::SetParGDB (const Geometry            & geom,
                                        const DistributionMapping & dmap,
                                        const BoxArray            & ba)
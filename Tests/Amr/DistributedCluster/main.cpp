@@ -0,0 +1,135 @@
+#include <AMReX.H>
+#include <AMReX_AmrMesh.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+
+using namespace amrex;
+
+namespace {
+
+// Tags the cells near the surface of a sphere that crosses the periodic
+// boundary in x.
+class ClusterTest
+    : public AmrMesh
+{
+public:
+    ClusterTest (Real a_shell_width, bool distributed)
+        : m_shell_width(a_shell_width)
+    {
+        SetDistributedClustering(distributed);
+    }
+
+    void ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/) override
+    {
+        const auto problo = Geom(lev).ProbLoArray();
+        const auto dx = Geom(lev).CellSizeArray();
+        const Real w = m_shell_width;
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+            auto const& t = tags.array(mfi);
+            amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                if (is_tagged(i, j, k, problo, dx, w)) {
+                    t(i,j,k) = TagBox::SET;
+                }
+            });
+        }
+    }
+
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    static bool is_tagged (int i, int j, int k, GpuArray<Real,AMREX_SPACEDIM> const& problo,
+                           GpuArray<Real,AMREX_SPACEDIM> const& dx, Real w) noexcept
+    {
+        Real x = problo[0] + (i+0.5_rt)*dx[0] - 0.9_rt;
+        Real y = problo[1] + (j+0.5_rt)*dx[1] - 0.5_rt;
+        x = std::min(std::abs(x), std::abs(x+1._rt)); // periodic in x
+        Real r2 = x*x + y*y;
+#if (AMREX_SPACEDIM == 3)
+        Real z = problo[2] + (k+0.5_rt)*dx[2] - 0.5_rt;
+        r2 += z*z;
+#else
+        amrex::ignore_unused(k);
+#endif
+        return std::abs(std::sqrt(r2) - 0.3_rt) < w;
+    }
+
+    void check () const
+    {
+        for (int lev = 1; lev <= finestLevel(); ++lev) {
+            BoxArray const& ba = boxArray(lev);
+            const IntVect bf = blockingFactor(lev);
+            const IntVect mgs = maxGridSize(lev);
+            AMREX_ALWAYS_ASSERT(ba.isDisjoint());
+            AMREX_ALWAYS_ASSERT(Geom(lev).Domain().contains(ba.minimalBox()));
+            for (int i = 0, N = static_cast<int>(ba.size()); i < N; ++i) {
+                Box const& b = ba[i];
+                AMREX_ALWAYS_ASSERT(b.coarsenable(bf));
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    AMREX_ALWAYS_ASSERT(b.length(idim) <= mgs[idim]);
+                }
+            }
+
+            // Every tagged cell of the coarse level is covered.
+            BoxArray cba = amrex::coarsen(ba, refRatio(lev-1));
+            const auto problo = Geom(lev-1).ProbLoArray();
+            const auto dx = Geom(lev-1).CellSizeArray();
+            const Real w = m_shell_width;
+            Long nmissed = 0;
+            BoxArray const& crse_ba = boxArray(lev-1);
+            for (int i = 0, N = static_cast<int>(crse_ba.size()); i < N; ++i) {
+                if (i % ParallelDescriptor::NProcs() != ParallelDescriptor::MyProc()) { continue; }
+                amrex::LoopOnCpu(crse_ba[i], [&] (int ii, int jj, int kk)
+                {
+                    if (is_tagged(ii, jj, kk, problo, dx, w) &&
+                        !cba.contains(IntVect(AMREX_D_DECL(ii,jj,kk))))
+                    {
+                        ++nmissed;
+                    }
+                });
+            }
+            ParallelDescriptor::ReduceLongSum(nmissed);
+            AMREX_ALWAYS_ASSERT(nmissed == 0);
+        }
+    }
+
+private:
+    Real m_shell_width;
+};
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Real shell_width = 0.02;
+        int ntests = 2;
+        {
+            ParmParse pp;
+            pp.query("shell_width", shell_width);
+            pp.query("ntests", ntests);
+        }
+
+        for (int itest = 0; itest < ntests; ++itest) {
+            for (bool distributed : {false, true}) {
+                ClusterTest amr(shell_width, distributed);
+                double t0 = amrex::second();
+                amr.MakeNewGrids(0.0);
+                double t = amrex::second() - t0;
+                ParallelDescriptor::ReduceRealMax(t);
+
+                amr.check();
+
+                amrex::Print() << (distributed ? "Distributed" : "Serial     ")
+                               << " clustering: time = " << t << " s";
+                for (int lev = 1; lev <= amr.finestLevel(); ++lev) {
+                    amrex::Print() << ", level " << lev << ": "
+                                   << amr.boxArray(lev).size() << " grids, "
+                                   << amr.boxArray(lev).numPts() << " cells";
+                }
+                amrex::Print() << "\n";
+            }
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,159 @@
+#include <AMReX.H>
+#include <AMReX_BArena.H>
+#include <AMReX_CArena.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_SArena.H>
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <thread>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// Returns a random size in bytes for the given allocation size mix.
+std::size_t random_size (std::string const& mix, std::mt19937& gen)
+{
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    auto log_uniform = [&] (double lo, double hi) {
+        return static_cast<std::size_t>(std::exp(std::log(lo) + u(gen)*(std::log(hi)-std::log(lo))));
+    };
+    if (mix == "small") {          // small temporaries
+        return log_uniform(16., 4096.);
+    } else if (mix == "fab") {     // tile-sized FArrayBoxes
+        return log_uniform(4096., 1024.*1024.);
+    } else if (mix == "mixed") {   // mostly small with some large allocations
+        return (u(gen) < 0.9) ? log_uniform(16., 64.*1024.)
+                              : log_uniform(1024.*1024., 8.*1024.*1024.);
+    } else {
+        amrex::Abort("Unknown mix " + mix);
+        return 0;
+    }
+}
+
+// Stamp the size at both ends of a block so that overlapping blocks are caught.
+void stamp (void* p, std::size_t nbytes)
+{
+    char* c = static_cast<char*>(p);
+    std::memcpy(c, &nbytes, sizeof(nbytes));
+    std::memcpy(c + nbytes - sizeof(nbytes), &nbytes, sizeof(nbytes));
+}
+
+void check (void* p)
+{
+    char* c = static_cast<char*>(p);
+    std::size_t nbytes, nbytes_end;
+    std::memcpy(&nbytes, c, sizeof(nbytes));
+    std::memcpy(&nbytes_end, c + nbytes - sizeof(nbytes), sizeof(nbytes));
+    AMREX_ALWAYS_ASSERT(nbytes == nbytes_end);
+}
+
+struct Slot {
+    std::atomic<void*> p{nullptr};
+};
+
+}
+
+void main_main ()
+{
+    Vector<int> nthreads{1, 2, 4};
+    int niters = 20000;
+    int nslots = 64;
+    Vector<std::string> mixes{"small", "fab", "mixed"};
+    bool cross_thread = true;
+    {
+        ParmParse pp;
+        pp.queryarr("nthreads", nthreads);
+        pp.query("niters", niters);
+        pp.query("nslots", nslots);
+        pp.queryarr("mixes", mixes);
+        pp.query("cross_thread", cross_thread);
+    }
+
+    auto make_arena = [] (std::string const& name) -> std::unique_ptr<Arena>
+    {
+        if (name == "BArena") {
+            return std::make_unique<BArena>();
+        } else if (name == "CArena") {
+            return std::make_unique<CArena>(0, ArenaInfo{}.SetCpuMemory());
+        } else {
+            return std::make_unique<SArena>(0, ArenaInfo{}.SetCpuMemory());
+        }
+    };
+
+    amrex::Print() << "   arena    mix  threads  cross   Mops/s\n";
+
+    for (bool xthread : {false, true}) {
+        if (xthread && !cross_thread) { continue; }
+        for (auto const& mix : mixes) {
+            for (int nt : nthreads) {
+                for (std::string name : {"BArena", "CArena", "SArena"}) {
+                    auto arena = make_arena(name);
+
+                    // Each thread owns nslots slots.  In cross-thread mode the
+                    // threads pick slots from the whole set, so that blocks are
+                    // often freed by a thread other than the one that allocated them.
+                    Vector<Slot> slots(nt*nslots);
+
+                    auto work = [&] (int tid)
+                    {
+                        std::mt19937 gen(1234 + tid);
+                        std::uniform_int_distribution<int> pick
+                            (xthread ? 0 : tid*nslots, xthread ? nt*nslots-1 : (tid+1)*nslots-1);
+                        for (int it = 0; it < niters; ++it) {
+                            std::size_t nbytes = std::max(random_size(mix, gen),
+                                                          2*sizeof(std::size_t));
+                            void* p = arena->alloc(nbytes);
+                            stamp(p, nbytes);
+                            void* old = slots[pick(gen)].p.exchange(p);
+                            if (old) {
+                                check(old);
+                                arena->free(old);
+                            }
+                        }
+                    };
+
+                    double t0 = ParallelDescriptor::second();
+                    {
+                        Vector<std::thread> threads;
+                        for (int tid = 1; tid < nt; ++tid) {
+                            threads.emplace_back(work, tid);
+                        }
+                        work(0);
+                        for (auto& t : threads) { t.join(); }
+                    }
+                    double t = ParallelDescriptor::second() - t0;
+
+                    for (auto& s : slots) {
+                        if (void* p = s.p.load()) {
+                            check(p);
+                            arena->free(p);
+                        }
+                    }
+                    arena->freeUnused();
+
+                    amrex::Print() << std::setw(8) << name << std::setw(7) << mix
+                                   << std::setw(9) << nt << std::setw(7) << xthread
+                                   << std::setw(9) << std::setprecision(3)
+                                   << double(nt)*niters/t*1.e-6 << "\n";
+                }
+            }
+        }
+    }
+}
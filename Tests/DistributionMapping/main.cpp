@@ -0,0 +1,180 @@
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_BoxIterator.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_RealVect.H>
+
+#include <algorithm>
+#include <numeric>
+
+using namespace amrex;
+
+void test ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    test();
+    amrex::Finalize();
+}
+
+namespace {
+
+struct MapStats
+{
+    Real efficiency = 0;
+    Long edge_cut = 0;
+};
+
+// The mappings are computed for a mock number of processes that is
+// independent of the number of MPI ranks we are running on.
+MapStats
+getStats (BoxArray const& ba, std::vector<std::vector<int> > const& parts, int nprocs)
+{
+    AMREX_ALWAYS_ASSERT(static_cast<int>(parts.size()) == nprocs);
+
+    Vector<int> pmap(ba.size(), -1);
+    Vector<Long> wgts(nprocs, 0);
+    for (int ip = 0; ip < nprocs; ++ip) {
+        for (int ibox : parts[ip]) {
+            AMREX_ALWAYS_ASSERT(pmap[ibox] == -1);
+            pmap[ibox] = ip;
+            wgts[ip] += ba[ibox].numPts();
+        }
+    }
+    for (int p : pmap) {
+        AMREX_ALWAYS_ASSERT(p >= 0);
+    }
+
+    Long max_wgt = *std::max_element(wgts.begin(), wgts.end());
+    Long sum_wgt = std::accumulate(wgts.begin(), wgts.end(), Long(0));
+
+    int ngrow = 1;
+    ParmParse pp("DistributionMapping");
+    pp.query("graph_ngrow", ngrow);
+
+    MapStats r;
+    r.efficiency = static_cast<Real>(sum_wgt) / (static_cast<Real>(nprocs)*static_cast<Real>(max_wgt));
+    r.edge_cut = DistributionMapping::ComputeEdgeCut(DistributionMapping(std::move(pmap)),
+                                                     ba, IntVect(ngrow));
+    return r;
+}
+
+void
+compare (std::string const& name, BoxArray const& ba, int nprocs)
+{
+    auto const sfc = getStats(ba, DistributionMapping::makeSFC(ba, true, nprocs), nprocs);
+    auto const graph = getStats(ba, DistributionMapping::makeGraph(ba, true, nprocs), nprocs);
+
+    amrex::Print() << name << ": " << ba.size() << " boxes on " << nprocs << " processes\n"
+                   << "    SFC   efficiency: " << sfc.efficiency
+                   << ", edge cut: " << sfc.edge_cut << "\n"
+                   << "    GRAPH efficiency: " << graph.efficiency
+                   << ", edge cut: " << graph.edge_cut << "\n";
+
+    AMREX_ALWAYS_ASSERT(graph.efficiency > 0.9_rt);
+    AMREX_ALWAYS_ASSERT(graph.edge_cut <= sfc.edge_cut);
+}
+
+// Bytes of ghost cell data that are sent between nodes
+Long
+offNodeBytes (BoxArray const& ba, std::vector<std::vector<int> > const& parts,
+              Vector<int> const& rank_node, int ngrow, int ncomp)
+{
+    Vector<int> pmap(ba.size(), -1);
+    for (int ip = 0, np = parts.size(); ip < np; ++ip) {
+        for (int ibox : parts[ip]) {
+            AMREX_ALWAYS_ASSERT(pmap[ibox] == -1);
+            pmap[ibox] = ip;
+        }
+    }
+
+    Long bytes = 0;
+    std::vector< std::pair<int,Box> > isects;
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        ba.intersections(amrex::grow(ba[i],ngrow), isects);
+        for (auto const& is : isects) {
+            if (rank_node[pmap[is.first]] != rank_node[pmap[i]]) {
+                bytes += is.second.numPts() * ncomp * Long(sizeof(Real));
+            }
+        }
+    }
+    return bytes;
+}
+
+// Ranks are placed on nodes cyclically as with e.g. srun --distribution=cyclic.
+void
+compareNodeAware (std::string const& name, BoxArray const& ba, int nprocs, int ranks_per_node)
+{
+    const int nnodes = nprocs / ranks_per_node;
+    AMREX_ALWAYS_ASSERT(nnodes*ranks_per_node == nprocs);
+
+    Vector<int> rank_node(nprocs);
+    Vector<Vector<int> > node_ranks(nnodes);
+    for (int i = 0; i < nprocs; ++i) {
+        rank_node[i] = i % nnodes;
+        node_ranks[rank_node[i]].push_back(i);
+    }
+
+    const int ngrow = 2;
+    const int ncomp = 4;
+    auto const sfc = DistributionMapping::makeSFC(ba, true, nprocs);
+    auto const nodesfc = DistributionMapping::makeSFC(ba, node_ranks, true);
+    const Long sfc_bytes = offNodeBytes(ba, sfc, rank_node, ngrow, ncomp);
+    const Long nodesfc_bytes = offNodeBytes(ba, nodesfc, rank_node, ngrow, ncomp);
+
+    amrex::Print() << name << ": off-node bytes on " << nnodes << " nodes with "
+                   << ranks_per_node << " ranks each\n"
+                   << "    SFC            : " << sfc_bytes << "\n"
+                   << "    SFC node aware : " << nodesfc_bytes << "\n";
+
+    AMREX_ALWAYS_ASSERT(getStats(ba, nodesfc, nprocs).efficiency > 0.9_rt);
+    AMREX_ALWAYS_ASSERT(nodesfc_bytes < sfc_bytes);
+}
+
+}
+
+void test ()
+{
+    int n_cell = 256;
+    int max_grid_size = 32;
+    int nprocs = 48;
+    int ranks_per_node = 12;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nprocs", nprocs);
+        pp.query("ranks_per_node", ranks_per_node);
+    }
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    compare("Uniform", ba, nprocs);
+
+    // Boxes covering a spherical shell like a refined level would
+    BoxList bl;
+    const Real r0 = 0.25_rt*n_cell;
+    const Real r1 = 0.40_rt*n_cell;
+    const int bf = max_grid_size/2;
+    for (BoxIterator bi(amrex::coarsen(domain,bf)); bi.ok(); ++bi) {
+        Box b = amrex::refine(Box(bi(),bi()), bf);
+        RealVect d;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            d[idim] = Real(0.5)*(b.smallEnd(idim)+b.bigEnd(idim)+1) - Real(0.5)*n_cell;
+        }
+        const Real r = d.vectorLength();
+        if (r >= r0 && r <= r1) bl.push_back(b);
+    }
+    bl.simplify();
+    BoxArray shell(bl);
+    shell.maxSize(max_grid_size);
+    compare("Shell", shell, nprocs);
+
+    compareNodeAware("Uniform", ba, nprocs, ranks_per_node);
+    compareNodeAware("Shell", shell, nprocs, ranks_per_node);
+}
@@ -0,0 +1,165 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <limits>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// The union of all the spheres evaluated the brute-force way.
+class AllSpheresIF
+{
+public:
+    explicit AllSpheresIF (Vector<EB2::SphereIF> const& a_spheres) : m_spheres(a_spheres) {}
+
+    Real operator() (const RealArray& p) const noexcept
+    {
+        Real r = std::numeric_limits<Real>::lowest();
+        for (auto const& s : m_spheres) {
+            r = amrex::max(r, s(p));
+        }
+        return r;
+    }
+
+private:
+    Vector<EB2::SphereIF> m_spheres;
+};
+
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    Real r = 0.0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& aa = a.const_array(mfi);
+        auto const& ba = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), a.nComp(), [&] (int i, int j, int k, int n)
+        {
+            r = amrex::max(r, std::abs(aa(i,j,k,n)-ba(i,j,k,n)));
+        });
+    }
+    return r;
+}
+
+Real max_diff (MultiCutFab const& a, MultiCutFab const& b)
+{
+    Real r = 0.0;
+    for (MFIter mfi(a.data()); mfi.isValid(); ++mfi) {
+        AMREX_ALWAYS_ASSERT(a.ok(mfi) == b.ok(mfi));
+        if (a.ok(mfi)) {
+            auto const& aa = a.const_array(mfi);
+            auto const& ba = b.const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), a.nComp(), [&] (int i, int j, int k, int n)
+            {
+                r = amrex::max(r, std::abs(aa(i,j,k,n)-ba(i,j,k,n)));
+            });
+        }
+    }
+    return r;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    int nbed = 10;
+    Real radius = 0.03;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nbed", nbed);
+        pp.query("radius", radius);
+    }
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    // Spheres on a lattice, jittered by a deterministic hash of their index.
+    Vector<EB2::SphereIF> spheres;
+    Vector<RealBox> bboxes;
+    const Real spacing = 1.0/nbed;
+    const Real jitter = 0.05*spacing;
+    for (int k = 0; k < nbed; ++k) {
+    for (int j = 0; j < nbed; ++j) {
+    for (int i = 0; i < nbed; ++i) {
+        const int id = i + nbed*(j + nbed*k);
+        RealArray c;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const Real h = std::sin(Real(12.9898*id + 78.233*idim)) * 43758.5453;
+            const int ijk = (idim == 0) ? i : ((idim == 1) ? j : k);
+            c[idim] = (ijk+0.5)*spacing + jitter*(2.0*(h-std::floor(h))-1.0);
+        }
+        spheres.emplace_back(radius, c, false);
+        bboxes.emplace_back(RealArray{AMREX_D_DECL(c[0]-radius,c[1]-radius,c[2]-radius)},
+                            RealArray{AMREX_D_DECL(c[0]+radius,c[1]+radius,c[2]+radius)});
+    }}}
+
+    const Vector<int> ng{2,2,2};
+
+    Real t0 = amrex::second();
+    EB2::Build(EB2::makeShop(AllSpheresIF(spheres)), geom, 0, 0);
+    auto fact_all = makeEBFabFactory(geom, ba, dm, ng, EBSupport::full);
+    const Real t_all = amrex::second() - t0;
+
+    t0 = amrex::second();
+    EB2::BinnedUnion<EB2::SphereIF> binned(spheres, bboxes, 2.0*geom.CellSize(0));
+    EB2::Build(EB2::makeShop(binned.getIF(), binned), geom, 0, 0);
+    auto fact_binned = makeEBFabFactory(geom, ba, dm, ng, EBSupport::full);
+    const Real t_binned = amrex::second() - t0;
+
+    amrex::Print() << spheres.size() << " spheres in " << binned.numBins() << " bins, "
+                   << binned.avgBodiesPerBin() << " per bin\n"
+                   << "Build time: all spheres " << t_all << " s, binned " << t_binned
+                   << " s\n";
+
+    // The cell types have to be the same, and the cut cell data the same
+    // up to the tolerance of the root finder.
+    Long ndiff = 0;
+    auto const& fa = fact_all->getMultiEBCellFlagFab();
+    auto const& fb = fact_binned->getMultiEBCellFlagFab();
+    for (MFIter mfi(fa); mfi.isValid(); ++mfi) {
+        auto const& aa = fa.const_array(mfi);
+        auto const& bb = fb.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k)
+        {
+            if (aa(i,j,k) != bb(i,j,k)) { ++ndiff; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ndiff == 0, "Cell flags differ");
+
+    Real diff = max_diff(fact_all->getVolFrac(), fact_binned->getVolFrac());
+    diff = amrex::max(diff, max_diff(fact_all->getCentroid(), fact_binned->getCentroid()));
+    diff = amrex::max(diff, max_diff(fact_all->getBndryCent(), fact_binned->getBndryCent()));
+    diff = amrex::max(diff, max_diff(fact_all->getBndryArea(), fact_binned->getBndryArea()));
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        diff = amrex::max(diff, max_diff(*fact_all->getAreaFrac()[idim],
+                                         *fact_binned->getAreaFrac()[idim]));
+        diff = amrex::max(diff, max_diff(*fact_all->getFaceCent()[idim],
+                                         *fact_binned->getFaceCent()[idim]));
+    }
+    ParallelDescriptor::ReduceRealMax(diff);
+    amrex::Print() << "Max difference in EB data: " << diff << "\n";
+    AMREX_ALWAYS_ASSERT(diff < 1.e-10);
+}
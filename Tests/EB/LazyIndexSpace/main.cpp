@@ -0,0 +1,195 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+Long count_diff (MultiFab const& a, MultiFab const& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& aa = a.const_array(mfi);
+        auto const& ba = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), a.nComp(), [&] (int i, int j, int k, int n)
+        {
+            if (aa(i,j,k,n) != ba(i,j,k,n)) { ++ndiff; }
+        });
+    }
+    return ndiff;
+}
+
+Long count_diff (MultiCutFab const& a, MultiCutFab const& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a.data()); mfi.isValid(); ++mfi) {
+        if (a.ok(mfi) != b.ok(mfi)) {
+            ++ndiff;
+        } else if (a.ok(mfi)) {
+            auto const& aa = a.const_array(mfi);
+            auto const& ba = b.const_array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), a.nComp(), [&] (int i, int j, int k, int n)
+            {
+                if (aa(i,j,k,n) != ba(i,j,k,n)) { ++ndiff; }
+            });
+        }
+    }
+    return ndiff;
+}
+
+// Compare the EB data of the two factories, which have the same BoxArray
+// and DistributionMapping, including ghost cells.
+void compare (EBFArrayBoxFactory const& a, EBFArrayBoxFactory const& b)
+{
+    Long ndiff = 0;
+
+    auto const& fa = a.getMultiEBCellFlagFab();
+    auto const& fb = b.getMultiEBCellFlagFab();
+    for (MFIter mfi(fa); mfi.isValid(); ++mfi) {
+        if (fa[mfi].getType() != fb[mfi].getType()) { ++ndiff; }
+        auto const& aa = fa.const_array(mfi);
+        auto const& ba = fb.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k)
+        {
+            if (aa(i,j,k) != ba(i,j,k)) { ++ndiff; }
+        });
+    }
+
+    ndiff += count_diff(a.getVolFrac(), b.getVolFrac());
+    ndiff += count_diff(a.getCentroid(), b.getCentroid());
+    ndiff += count_diff(a.getBndryCent(), b.getBndryCent());
+    ndiff += count_diff(a.getBndryArea(), b.getBndryArea());
+    ndiff += count_diff(a.getBndryNormal(), b.getBndryNormal());
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        ndiff += count_diff(*a.getAreaFrac()[idim], *b.getAreaFrac()[idim]);
+        ndiff += count_diff(*a.getFaceCent()[idim], *b.getFaceCent()[idim]);
+        ndiff += count_diff(*a.getEdgeCent()[idim], *b.getEdgeCent()[idim]);
+    }
+
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ndiff == 0, "Lazily built EB data differ from full build");
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    Real radius = 0.3;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("radius", radius);
+    }
+    int eb_max_grid_size = 64;
+    {
+        ParmParse pp("eb2");
+        pp.query("max_grid_size", eb_max_grid_size);
+    }
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+    Geometry cgeom = amrex::coarsen(geom, 2);
+
+    EB2::SphereIF sphere(radius, {AMREX_D_DECL(0.5,0.5,0.5)}, false);
+    auto gshop = EB2::makeShop(sphere);
+
+    // A full build with the coarse level made by coarsening
+    EB2::Build(gshop, geom, 1, 1);
+    EB2::IndexSpace const* full = &EB2::IndexSpace::top();
+
+    EB2::BuildLazy(gshop, geom, 1);
+    auto const* lazy = dynamic_cast<EB2::IndexSpaceLazy<decltype(gshop)> const*>
+        (&EB2::IndexSpace::top());
+    AMREX_ALWAYS_ASSERT(lazy != nullptr && lazy->builtBoxes(geom).empty());
+
+    const Vector<int> ng{2,2,2};
+    const Long ncells = domain.numPts();
+
+    // A region cut by the sphere near the lower corner, and then one near
+    // the upper corner as if the grids had been regridded.
+    const Vector<Box> regions{Box(IntVect(n_cell/8), IntVect(3*n_cell/8-1)),
+                              Box(IntVect(5*n_cell/8), IntVect(7*n_cell/8-1))};
+    for (int iregion = 0; iregion < regions.size(); ++iregion)
+    {
+        BoxArray ba(regions[iregion]);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        auto fact_full = makeEBFabFactory(full, geom, ba, dm, ng, EBSupport::full);
+        auto fact_lazy = makeEBFabFactory(lazy, geom, ba, dm, ng, EBSupport::full);
+        compare(*fact_full, *fact_lazy);
+
+        BoxArray cba = amrex::coarsen(ba, 2);
+        auto cfact_full = makeEBFabFactory(full, cgeom, cba, dm, ng, EBSupport::full);
+        auto cfact_lazy = makeEBFabFactory(lazy, cgeom, cba, dm, ng, EBSupport::full);
+        compare(*cfact_full, *cfact_lazy);
+
+        const Long nbuilt = lazy->builtBoxes(geom).numPts();
+        amrex::Print() << "Region " << iregion << ": EB data built on " << nbuilt << " of "
+                       << ncells << " cells\n";
+        AMREX_ALWAYS_ASSERT(nbuilt < ncells);
+    }
+
+    // Asking again for the same grids builds nothing new.
+    {
+        const Long nbuilt = lazy->builtBoxes(geom).numPts();
+        BoxArray ba(regions[0]);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        auto fact_lazy = makeEBFabFactory(lazy, geom, ba, dm, ng, EBSupport::full);
+        AMREX_ALWAYS_ASSERT(lazy->builtBoxes(geom).numPts() == nbuilt);
+    }
+
+    // A coarse level over the whole domain and a small refined patch, as at
+    // the start of an AMR run.  The coarse level does not build the fine
+    // level, and the fine level is only built around the patch.
+    {
+        EB2::Build(gshop, cgeom, 0, 0);
+        EB2::IndexSpace const* crse_full = &EB2::IndexSpace::top();
+
+        EB2::BuildLazy(gshop, geom, 1);
+        auto const* lazy2 = dynamic_cast<EB2::IndexSpaceLazy<decltype(gshop)> const*>
+            (&EB2::IndexSpace::top());
+        AMREX_ALWAYS_ASSERT(lazy2 != nullptr);
+
+        BoxArray cba(cgeom.Domain());
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+        auto cfact_full = makeEBFabFactory(crse_full, cgeom, cba, cdm, ng, EBSupport::full);
+        auto cfact_lazy = makeEBFabFactory(lazy2, cgeom, cba, cdm, ng, EBSupport::full);
+        compare(*cfact_full, *cfact_lazy);
+        AMREX_ALWAYS_ASSERT(lazy2->builtBoxes(geom).empty());
+
+        const Box patch(IntVect(n_cell/4), IntVect(n_cell/2-1));
+        BoxArray ba(patch);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        auto fact_full = makeEBFabFactory(full, geom, ba, dm, ng, EBSupport::full);
+        auto fact_lazy = makeEBFabFactory(lazy2, geom, ba, dm, ng, EBSupport::full);
+        compare(*fact_full, *fact_lazy);
+
+        // The patch and its ghost cells touch the boxes of one layer around it.
+        const Long nbuilt = lazy2->builtBoxes(geom).numPts();
+        amrex::Print() << "Patch of " << patch.numPts() << " cells: EB data built on "
+                       << nbuilt << " fine cells\n";
+        AMREX_ALWAYS_ASSERT(nbuilt <= amrex::grow(patch, eb_max_grid_size).numPts());
+    }
+}
@@ -0,0 +1,195 @@
+#include <AMReX.H>
+#include <AMReX_EB_STL_utils.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// Write a bumpy sphere as a binary STL file with outward normals.
+void write_sphere (std::string const& fname, int nlat, int nlon)
+{
+    auto point = [&] (int i, int j) -> Array<float,3>
+    {
+        double theta = M_PI * i / nlat;
+        double phi = 2.0 * M_PI * j / nlon;
+        double r = 0.6 + 0.05 * std::sin(5.0*theta) * std::sin(4.0*phi);
+        return {float(r*std::sin(theta)*std::cos(phi)),
+                float(r*std::sin(theta)*std::sin(phi)),
+                float(r*std::cos(theta))};
+    };
+
+    std::vector<Array<Array<float,3>,3>> tris;
+    for (int i = 0; i < nlat; ++i) {
+        for (int j = 0; j < nlon; ++j) {
+            auto a = point(i  ,j  );
+            auto b = point(i+1,j  );
+            auto c = point(i+1,j+1);
+            auto d = point(i  ,j+1);
+            if (i != nlat-1) { tris.push_back({a,b,c}); } // degenerate at the south pole
+            if (i != 0     ) { tris.push_back({a,c,d}); } // degenerate at the north pole
+        }
+    }
+
+    std::ofstream ofs(fname, std::ios::binary);
+    char header[80] = "binary STL of a bumpy sphere";
+    ofs.write(header, 80);
+    auto ntri = static_cast<std::uint32_t>(tris.size());
+    ofs.write(reinterpret_cast<char const*>(&ntri), sizeof(ntri));
+    for (auto const& t : tris) {
+        float normal[3] = {0.f, 0.f, 0.f};
+        std::uint16_t attr = 0;
+        ofs.write(reinterpret_cast<char const*>(normal), sizeof(normal));
+        for (auto const& v : t) {
+            ofs.write(reinterpret_cast<char const*>(v.data()), 3*sizeof(float));
+        }
+        ofs.write(reinterpret_cast<char const*>(&attr), sizeof(attr));
+    }
+}
+
+}
+
+void main_main ()
+{
+    int nlat = 64;
+    int nlon = 64;
+    int n_cell = 32;
+    bool do_brute_force = true;
+    std::string stl_file = "sphere.stl";
+    {
+        ParmParse pp;
+        pp.query("nlat", nlat);
+        pp.query("nlon", nlon);
+        pp.query("n_cell", n_cell);
+        pp.query("do_brute_force", do_brute_force);
+        pp.query("stl_file", stl_file);
+    }
+
+    if (ParallelDescriptor::IOProcessor()) {
+        write_sphere(stl_file, nlat, nlon);
+    }
+    ParallelDescriptor::Barrier();
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({AMREX_D_DECL(-1.0_rt,-1.0_rt,-1.0_rt)}, {AMREX_D_DECL(1.0_rt,1.0_rt,1.0_rt)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+    const Box nodal_box = amrex::surroundingNodes(domain);
+
+    struct Result {
+        BaseFab<Real> levelset;
+        Array<BaseFab<Real>,AMREX_SPACEDIM> inter;
+    };
+
+    auto run = [&] (bool use_bvh, Result& res)
+    {
+        std::string const name = use_bvh ? "BVH        " : "Brute force";
+
+        STLtools stl;
+        stl.setUseBVH(use_bvh);
+        double t0 = amrex::second();
+        stl.read_stl_file(stl_file, 1.0_rt, {0.0_rt, 0.0_rt, 0.0_rt}, 0);
+        double t_prepare = amrex::second() - t0;
+
+        res.levelset.resize(nodal_box, 1);
+        t0 = amrex::second();
+        stl.fillFab(res.levelset, geom, RunOn::Gpu, nodal_box);
+        Gpu::streamSynchronize();
+        double t_fill = amrex::second() - t0;
+
+        // The edges whose nodes have different signs are irregular.
+        auto const& lst = res.levelset.const_array();
+        Array<BaseFab<EB2::Type_t>,AMREX_SPACEDIM> type;
+        Array<Array4<Real>,AMREX_SPACEDIM> inter_arr;
+        Array<Array4<EB2::Type_t const>,AMREX_SPACEDIM> type_arr;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const Box ebx = amrex::enclosedCells(nodal_box, idim);
+            res.inter[idim].resize(ebx, 1);
+            type[idim].resize(ebx, 1);
+            auto const& t = type[idim].array();
+            IntVect iv = IntVect::TheDimensionVector(idim);
+            ParallelFor(ebx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                Real l0 = lst(i,j,k);
+                Real l1 = lst(i+iv[0],j+iv[1],k+iv[2]);
+                t(i,j,k) = (l0*l1 < 0._rt) ? EB2::Type::irregular
+                    : ((l0 < 0._rt) ? EB2::Type::regular : EB2::Type::covered);
+            });
+            inter_arr[idim] = res.inter[idim].array();
+            type_arr[idim] = type[idim].const_array();
+        }
+        t0 = amrex::second();
+        stl.getIntercept(inter_arr, type_arr, lst, geom, RunOn::Gpu, nodal_box);
+        Gpu::streamSynchronize();
+        double t_inter = amrex::second() - t0;
+
+        amrex::Print() << name << ": read and prepare " << t_prepare << " s, fillFab "
+                       << t_fill << " s, getIntercept " << t_inter << " s";
+        if (use_bvh) {
+            amrex::Print() << ", " << stl.numBVHNodes() << " BVH nodes";
+        }
+        amrex::Print() << "\n";
+    };
+
+    amrex::Print() << "Number of triangles: " << 2*nlon*(nlat-1) << ", number of nodes: "
+                   << nodal_box.numPts() << "\n";
+
+    Result bvh;
+    run(true, bvh);
+
+    if (do_brute_force) {
+        Result brute;
+        run(false, brute);
+
+        Long nerr;
+        {
+            ReduceOps<ReduceOpSum> reduce_op;
+            ReduceData<Long> reduce_data(reduce_op);
+            using ReduceTuple = typename decltype(reduce_data)::Type;
+            auto const& a = bvh.levelset.const_array();
+            auto const& b = brute.levelset.const_array();
+            reduce_op.eval(nodal_box, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                return { a(i,j,k) != b(i,j,k) };
+            });
+            nerr = amrex::get<0>(reduce_data.value(reduce_op));
+        }
+        amrex::Print() << "Number of different level set values: " << nerr << "\n";
+        AMREX_ALWAYS_ASSERT(nerr == 0);
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const Box ebx = bvh.inter[idim].box();
+            ReduceOps<ReduceOpMax> reduce_op;
+            ReduceData<Real> reduce_data(reduce_op);
+            using ReduceTuple = typename decltype(reduce_data)::Type;
+            auto const& a = bvh.inter[idim].const_array();
+            auto const& b = brute.inter[idim].const_array();
+            reduce_op.eval(ebx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                if (amrex::isnan(a(i,j,k)) && amrex::isnan(b(i,j,k))) {
+                    return { 0._rt };
+                }
+                return { std::abs(a(i,j,k)-b(i,j,k)) };
+            });
+            Real max_diff = amrex::get<0>(reduce_data.value(reduce_op));
+            amrex::Print() << "Max intercept difference in direction " << idim << ": "
+                           << max_diff << "\n";
+            AMREX_ALWAYS_ASSERT(max_diff == 0._rt);
+        }
+    }
+}
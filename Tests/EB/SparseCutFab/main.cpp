@@ -0,0 +1,147 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_MultiSparseCutFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+Long dense_bytes (MultiCutFab const& dense)
+{
+    Long r = 0;
+    for (MFIter mfi(dense.data()); mfi.isValid(); ++mfi) {
+        if (dense.ok(mfi)) { r += dense[mfi].nBytes(); }
+    }
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+// Check the sparse data against the dense data entry by entry, and the
+// stored entries against their cells.  Return the bytes used.
+Long check (MultiCutFab const& dense, MultiSparseCutFab const& sparse,
+            MultiCutFab const& unpacked, std::string const& name)
+{
+    Long nwrong = 0;
+    for (MFIter mfi(dense.data()); mfi.isValid(); ++mfi)
+    {
+        if (!dense.ok(mfi)) { continue; }
+        Array4<Real const> const& d = dense.const_array(mfi);
+        Array4<Real const> const& u = unpacked.const_array(mfi);
+        SparseCutArray<Real const> const& s = sparse.const_array(mfi);
+        const Box& bx = mfi.fabbox();
+        const int ncomp = dense.nComp();
+        amrex::LoopOnCpu(bx, ncomp, [&] (int i, int j, int k, int n)
+        {
+            if (d(i,j,k,n) != s(i,j,k,n) || d(i,j,k,n) != u(i,j,k,n)) { ++nwrong; }
+        });
+        for (int slot = 0; slot < s.nslots; ++slot) {
+            Dim3 c = s.cell(slot);
+            if (s.slot(c.x,c.y,c.z) != slot) { ++nwrong; }
+            for (int n = 0; n < ncomp; ++n) {
+                if (s.value(slot,n) != d(c.x,c.y,c.z,n)) { ++nwrong; }
+            }
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nwrong);
+
+    Long sparse_bytes = sparse.nBytes();
+    Long nslots = sparse.nSlots();
+    ParallelDescriptor::ReduceLongSum({sparse_bytes, nslots});
+    amrex::Print() << "  " << name << ": dense " << dense_bytes(dense) << " bytes, sparse "
+                   << sparse_bytes << " bytes, " << nslots << " stored entries\n";
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nwrong == 0, "Sparse cut cell data differ from dense data");
+    return sparse_bytes;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    Real inner_radius = 0.30;
+    Real outer_radius = 0.35;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("inner_radius", inner_radius);
+        pp.query("outer_radius", outer_radius);
+    }
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    const RealArray center{AMREX_D_DECL(0.5,0.5,0.5)};
+    EB2::SphereIF inner(inner_radius, center, false);
+    EB2::SphereIF outer(outer_radius, center, true);
+    auto shell = EB2::makeUnion(inner, outer);
+    auto gshop = EB2::makeShop(shell);
+    EB2::Build(gshop, geom, 0, 0);
+
+    const Vector<int> ng{2,2,2};
+    auto dense = makeEBFabFactory(geom, ba, dm, ng, EBSupport::full);
+    auto sparse = makeEBFabFactory(geom, ba, dm, ng, EBSupport::full, EBCutStorage::sparse);
+    AMREX_ALWAYS_ASSERT(sparse->cutStorage() == EBCutStorage::sparse);
+
+    Long ncut = 0, ncells_cut_boxes = 0;
+    auto const& flags = dense->getMultiEBCellFlagFab();
+    for (MFIter mfi(flags); mfi.isValid(); ++mfi) {
+        if (flags[mfi].getType() == FabType::singlevalued) {
+            const Box& bx = mfi.validbox();
+            ncells_cut_boxes += bx.numPts();
+            auto const& a = flags.const_array(mfi);
+            amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+            {
+                if (a(i,j,k).isSingleValued()) { ++ncut; }
+            });
+        }
+    }
+    ParallelDescriptor::ReduceLongSum({ncut, ncells_cut_boxes});
+    amrex::Print() << "Cut cells: " << ncut << " of " << ncells_cut_boxes
+                   << " cells in boxes with cut cells\n";
+
+    Long nbytes_dense = 0, nbytes_sparse = 0;
+    auto add = [&] (MultiCutFab const& d, MultiSparseCutFab const& s, MultiCutFab const& u,
+                    std::string const& name)
+    {
+        nbytes_dense += dense_bytes(d);
+        nbytes_sparse += check(d, s, u, name);
+    };
+
+    // The MultiCutFab getters of the sparse factory unpack the sparse data.
+    add(dense->getCentroid(), sparse->getSparseCentroid(), sparse->getCentroid(), "centroid ");
+    add(dense->getBndryCent(), sparse->getSparseBndryCent(), sparse->getBndryCent(), "bndrycent");
+    add(dense->getBndryArea(), sparse->getSparseBndryArea(), sparse->getBndryArea(), "bndryarea");
+    add(dense->getBndryNormal(), sparse->getSparseBndryNormal(), sparse->getBndryNormal(),
+        "bndrynorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        add(*dense->getAreaFrac()[idim], *sparse->getSparseAreaFrac()[idim],
+            *sparse->getAreaFrac()[idim], "areafrac" + std::to_string(idim));
+        add(*dense->getFaceCent()[idim], *sparse->getSparseFaceCent()[idim],
+            *sparse->getFaceCent()[idim], "facecent" + std::to_string(idim));
+        add(*dense->getEdgeCent()[idim], *sparse->getSparseEdgeCent()[idim],
+            *sparse->getEdgeCent()[idim], "edgecent" + std::to_string(idim));
+    }
+
+    amrex::Print() << "Total: dense " << nbytes_dense << " bytes, sparse " << nbytes_sparse
+                   << " bytes, ratio " << double(nbytes_sparse)/double(nbytes_dense) << "\n";
+}
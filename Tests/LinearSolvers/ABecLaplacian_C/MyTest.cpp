@@ -65,6 +65,9 @@ MyTest::solvePoisson ()
         mlmg.setMaxFmgIter(max_fmg_iter);
         mlmg.setVerbose(verbose);
         mlmg.setBottomVerbose(bottom_verbose);
+        if (use_chebyshev) {
+            mlmg.setSmoother(MLMG::Smoother::chebyshev, chebyshev_degree);
+        }
 #ifdef AMREX_USE_HYPRE
         if (use_hypre) {
             mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
@@ -106,6 +109,9 @@ MyTest::solvePoisson ()
             mlmg.setMaxFmgIter(max_fmg_iter);
             mlmg.setVerbose(verbose);
             mlmg.setBottomVerbose(bottom_verbose);
+            if (use_chebyshev) {
+                mlmg.setSmoother(MLMG::Smoother::chebyshev, chebyshev_degree);
+            }
 #ifdef AMREX_USE_HYPRE
             if (use_hypre) {
                 mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
@@ -182,6 +188,9 @@ MyTest::solveABecLaplacian ()
         mlmg.setMaxFmgIter(max_fmg_iter);
         mlmg.setVerbose(verbose);
         mlmg.setBottomVerbose(bottom_verbose);
+        if (use_chebyshev) {
+            mlmg.setSmoother(MLMG::Smoother::chebyshev, chebyshev_degree);
+        }
 #ifdef AMREX_USE_HYPRE
         if (use_hypre) {
             mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
@@ -239,6 +248,9 @@ MyTest::solveABecLaplacian ()
             mlmg.setMaxFmgIter(max_fmg_iter);
             mlmg.setVerbose(verbose);
             mlmg.setBottomVerbose(bottom_verbose);
+            if (use_chebyshev) {
+                mlmg.setSmoother(MLMG::Smoother::chebyshev, chebyshev_degree);
+            }
 #ifdef AMREX_USE_HYPRE
             if (use_hypre) {
                 mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
@@ -324,6 +336,9 @@ MyTest::solveABecLaplacianInhomNeumann ()
         mlmg.setMaxFmgIter(max_fmg_iter);
         mlmg.setVerbose(verbose);
         mlmg.setBottomVerbose(bottom_verbose);
+        if (use_chebyshev) {
+            mlmg.setSmoother(MLMG::Smoother::chebyshev, chebyshev_degree);
+        }
 #ifdef AMREX_USE_HYPRE
         if (use_hypre) {
             mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
@@ -381,6 +396,9 @@ MyTest::solveABecLaplacianInhomNeumann ()
             mlmg.setMaxFmgIter(max_fmg_iter);
             mlmg.setVerbose(verbose);
             mlmg.setBottomVerbose(bottom_verbose);
+            if (use_chebyshev) {
+                mlmg.setSmoother(MLMG::Smoother::chebyshev, chebyshev_degree);
+            }
 #ifdef AMREX_USE_HYPRE
             if (use_hypre) {
                 mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
@@ -433,6 +451,9 @@ MyTest::readParameters ()
     pp.query("max_coarsening_level", max_coarsening_level);
     pp.query("max_semicoarsening_level", max_semicoarsening_level);
 
+    pp.query("use_chebyshev", use_chebyshev);
+    pp.query("chebyshev_degree", chebyshev_degree);
+
 #ifdef AMREX_USE_HYPRE
     pp.query("use_hypre", use_hypre);
     pp.query("hypre_interface", hypre_interface_i);
@@ -0,0 +1,145 @@
+#include <AMReX.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <iomanip>
+#include <numeric>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    int max_coarsening_level = 2;
+    Vector<std::string> bottom_solvers{"bicgstab", "cg", "pipebicgstab", "pipecg", "sstepcg"};
+    int sstep = 4;
+    int verbose = 1;
+    int bottom_verbose = 0;
+    Real tol_rel = 1.e-10;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("max_coarsening_level", max_coarsening_level);
+        pp.queryarr("bottom_solvers", bottom_solvers);
+        pp.query("sstep", sstep);
+        pp.query("verbose", verbose);
+        pp.query("bottom_verbose", bottom_verbose);
+        pp.query("tol_rel", tol_rel);
+    }
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    // The exact solution is a product of sines with zero Dirichlet boundaries.
+    MultiFab rhs(ba, dm, 1, 0);
+    MultiFab exact(ba, dm, 1, 0);
+    MultiFab phi(ba, dm, 1, 1);
+    {
+        const auto problo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        const Real pi = Real(3.141592653589793238462643383279502884197);
+        for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            auto const& r = rhs.array(mfi);
+            auto const& e = exact.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                Real x = problo[0] + (i+0.5_rt)*dx[0];
+                Real y = problo[1] + (j+0.5_rt)*dx[1];
+                Real s = std::sin(pi*x) * std::sin(2._rt*pi*y);
+#if (AMREX_SPACEDIM == 3)
+                Real z = problo[2] + (k+0.5_rt)*dx[2];
+                s *= std::sin(3._rt*pi*z);
+                Real f = 14._rt*pi*pi;
+#else
+                amrex::ignore_unused(k);
+                Real f = 5._rt*pi*pi;
+#endif
+                e(i,j,k) = s;
+                r(i,j,k) = -f*s;
+            });
+        }
+    }
+
+    amrex::Print() << "      bottom solver  MLMG iters  bottom iters  reductions"
+                   << "  reductions/iter      error\n";
+
+    Real err0 = -1;
+    for (auto const& name : bottom_solvers)
+    {
+        MLMG::BottomSolver bottom_solver;
+        if (name == "bicgstab") {
+            bottom_solver = MLMG::BottomSolver::bicgstab;
+        } else if (name == "cg") {
+            bottom_solver = MLMG::BottomSolver::cg;
+        } else if (name == "pipebicgstab") {
+            bottom_solver = MLMG::BottomSolver::pipebicgstab;
+        } else if (name == "pipecg") {
+            bottom_solver = MLMG::BottomSolver::pipecg;
+        } else if (name == "sstepcg") {
+            bottom_solver = MLMG::BottomSolver::sstepcg;
+        } else {
+            amrex::Abort("Unknown bottom solver " + name);
+            return;
+        }
+
+        LPInfo info;
+        info.setMaxCoarseningLevel(max_coarsening_level);
+        MLPoisson mlpoisson({geom}, {ba}, {dm}, info);
+        mlpoisson.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                            LinOpBCType::Dirichlet,
+                                            LinOpBCType::Dirichlet)},
+                              {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                            LinOpBCType::Dirichlet,
+                                            LinOpBCType::Dirichlet)});
+        phi.setVal(0.0);
+        mlpoisson.setLevelBC(0, &phi);
+
+        MLMG mlmg(mlpoisson);
+        mlmg.setVerbose(verbose);
+        mlmg.setBottomVerbose(bottom_verbose);
+        mlmg.setBottomSolver(bottom_solver);
+        mlmg.setBottomSStep(sstep);
+        mlmg.solve({&phi}, {&rhs}, tol_rel, 0.0);
+
+        auto const& niters = mlmg.getNumCGIters();
+        auto const& nreductions = mlmg.getNumCGReductions();
+        const int nit = std::accumulate(niters.begin(), niters.end(), 0);
+        const int nred = std::accumulate(nreductions.begin(), nreductions.end(), 0);
+
+        MultiFab::Subtract(phi, exact, 0, 0, 1, 0);
+        const Real err = phi.norminf(0, 1, IntVect(0));
+
+        amrex::Print() << std::setw(19) << name << std::setw(12) << mlmg.getNumIters()
+                       << std::setw(14) << nit << std::setw(12) << nred
+                       << std::setw(17) << std::setprecision(3)
+                       << (nit > 0 ? Real(nred)/Real(nit) : 0._rt)
+                       << std::setw(11) << err << "\n";
+
+        // MLMG aborts if it does not converge.  All the bottom solvers
+        // must give the same discretization error.
+        if (err0 < 0) {
+            err0 = err;
+        } else {
+            AMREX_ALWAYS_ASSERT(std::abs(err-err0) <= 1.e-6_rt*err0);
+        }
+    }
+}
@@ -0,0 +1,177 @@
+#include <AMReX.H>
+#include <AMReX_FFT_Poisson.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+constexpr Real pi = Real(3.141592653589793238462643383279502884197);
+
+// Max norm of lap(soln) - (rhs - mean(rhs)), relative to that of rhs
+Real periodic_residual (Geometry const& geom, MultiFab& soln, MultiFab const& rhs)
+{
+    soln.FillBoundary(geom.periodicity());
+    const Real mean = rhs.sum() / geom.Domain().d_numPts();
+    const auto dxinv = geom.InvCellSizeArray();
+    MultiFab res(rhs.boxArray(), rhs.DistributionMap(), 1, 0);
+    for (MFIter mfi(res); mfi.isValid(); ++mfi) {
+        auto const& r = res.array(mfi);
+        auto const& f = rhs.const_array(mfi);
+        auto const& p = soln.const_array(mfi);
+        amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            Real lap = (p(i-1,j,k) - 2._rt*p(i,j,k) + p(i+1,j,k)) * dxinv[0]*dxinv[0]
+                +      (p(i,j-1,k) - 2._rt*p(i,j,k) + p(i,j+1,k)) * dxinv[1]*dxinv[1]
+                +      (p(i,j,k-1) - 2._rt*p(i,j,k) + p(i,j,k+1)) * dxinv[2]*dxinv[2];
+            r(i,j,k) = lap - (f(i,j,k) - mean);
+        });
+    }
+    return res.norm0() / rhs.norm0();
+}
+
+}
+
+void main_main ()
+{
+    Vector<int> n_cell{AMREX_D_DECL(60,48,50)};
+    int max_grid_size = 16;
+    int n_cell_open = 64;
+    Real radius = 0.08;
+    Vector<int> npencils{1};
+    int nsolves = 2;
+    {
+        ParmParse pp;
+        pp.queryarr("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("n_cell_open", n_cell_open);
+        pp.query("radius", radius);
+        pp.queryarr("npencils", npencils);
+        pp.query("nsolves", nsolves);
+    }
+
+    // Periodic domain
+    Box domain(IntVect(0), IntVect(n_cell)-1);
+    RealBox rb({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(1,1,1)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    MultiFab rhs(ba, dm, 1, 0);
+    MultiFab soln(ba, dm, 1, 1);
+    {
+        const auto problo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+            auto const& f = rhs.array(mfi);
+            amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                Real x = problo[0] + (i+0.5_rt)*dx[0];
+                Real y = problo[1] + (j+0.5_rt)*dx[1];
+                Real z = problo[2] + (k+0.5_rt)*dx[2];
+                f(i,j,k) = std::sin(2._rt*pi*x) * std::sin(4._rt*pi*y) * std::cos(2._rt*pi*z)
+                    + 0.3_rt*std::cos(6._rt*pi*x+0.1_rt) + 1._rt;
+            });
+        }
+    }
+
+    // Open domain, with a Gaussian charge at the center
+    Box domain_open(IntVect(0), IntVect(n_cell_open-1));
+    RealBox rb_open({AMREX_D_DECL(-0.5_rt,-0.5_rt,-0.5_rt)}, {AMREX_D_DECL(0.5_rt,0.5_rt,0.5_rt)});
+    Geometry geom_open(domain_open, rb_open, 0, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba_open(domain_open);
+    ba_open.maxSize(max_grid_size);
+    DistributionMapping dm_open(ba_open);
+
+    MultiFab rhs_open(ba_open, dm_open, 1, 0);
+    MultiFab exact_open(ba_open, dm_open, 1, 0);
+    MultiFab soln_open(ba_open, dm_open, 1, 0);
+    {
+        const auto problo = geom_open.ProbLoArray();
+        const auto dx = geom_open.CellSizeArray();
+        const Real a = radius;
+        const Real q = std::pow(pi,1.5_rt)*a*a*a;
+        for (MFIter mfi(rhs_open); mfi.isValid(); ++mfi) {
+            auto const& f = rhs_open.array(mfi);
+            auto const& e = exact_open.array(mfi);
+            amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                Real x = problo[0] + (i+0.5_rt)*dx[0];
+                Real y = problo[1] + (j+0.5_rt)*dx[1];
+                Real z = problo[2] + (k+0.5_rt)*dx[2];
+                Real r = std::sqrt(x*x+y*y+z*z);
+                f(i,j,k) = std::exp(-r*r/(a*a));
+                e(i,j,k) = -q/(4._rt*pi) * std::erf(r/a)/r;
+            });
+        }
+    }
+
+    // Accuracy with one pencil per process
+    {
+        FFT::Poisson solver(geom);
+        soln.setVal(0.0);
+        solver.solve(soln, rhs);
+        const Real residual = periodic_residual(geom, soln, rhs);
+        amrex::Print() << "Periodic: relative residual = " << residual << "\n";
+        AMREX_ALWAYS_ASSERT(residual < 1.e-10);
+
+        FFT::PoissonOpenBC solver_open(geom_open);
+        solver_open.solve(soln_open, rhs_open);
+        MultiFab::Subtract(soln_open, exact_open, 0, 0, 1, 0);
+        const Real error = soln_open.norm0() / exact_open.norm0();
+        amrex::Print() << "Open: relative error = " << error << "\n";
+        AMREX_ALWAYS_ASSERT(error < 1.e-2);
+    }
+
+    // Times with mock decompositions, whose solutions have to be the same.
+    amrex::Print() << "\n  pencils  periodic time  open time\n";
+    MultiFab soln0(ba, dm, 1, 0);
+    MultiFab soln_open0(ba_open, dm_open, 1, 0);
+    for (int ip = 0; ip < npencils.size(); ++ip)
+    {
+        FFT::Poisson solver(geom, npencils[ip]);
+        FFT::PoissonOpenBC solver_open(geom_open, npencils[ip]);
+
+        ParallelDescriptor::Barrier();
+        Real t0 = amrex::second();
+        for (int isolve = 0; isolve < nsolves; ++isolve) {
+            solver.solve(soln, rhs);
+        }
+        ParallelDescriptor::Barrier();
+        const Real t_periodic = (amrex::second() - t0) / nsolves;
+
+        t0 = amrex::second();
+        for (int isolve = 0; isolve < nsolves; ++isolve) {
+            solver_open.solve(soln_open, rhs_open);
+        }
+        ParallelDescriptor::Barrier();
+        const Real t_open = (amrex::second() - t0) / nsolves;
+
+        amrex::Print() << "  " << npencils[ip] << "        " << t_periodic
+                       << "    " << t_open << "\n";
+
+        if (ip == 0) {
+            MultiFab::Copy(soln0, soln, 0, 0, 1, 0);
+            MultiFab::Copy(soln_open0, soln_open, 0, 0, 1, 0);
+        } else {
+            MultiFab::Subtract(soln, soln0, 0, 0, 1, 0);
+            MultiFab::Subtract(soln_open, soln_open0, 0, 0, 1, 0);
+            AMREX_ALWAYS_ASSERT(soln.norm0() <= 1.e-12*soln0.norm0() &&
+                                soln_open.norm0() <= 1.e-12*soln_open0.norm0());
+        }
+    }
+}
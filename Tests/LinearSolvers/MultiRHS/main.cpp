@@ -0,0 +1,157 @@
+#include <AMReX.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    Vector<Real> scales{1.0_rt, 1.e-3_rt, 1.e3_rt, 1.e-6_rt};
+    int verbose = 1;
+    Real tol_rel = 1.e-10;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.queryarr("scales", scales);
+        pp.query("verbose", verbose);
+        pp.query("tol_rel", tol_rel);
+    }
+    const int ncomp = static_cast<int>(scales.size());
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    const Real ascalar = 1.0;
+    const Real bscalar = 1.0;
+
+    // The exact solution of component n is scales[n] times a product of
+    // sines with n+1 waves in x, with zero Dirichlet boundaries.
+    MultiFab rhs(ba, dm, ncomp, 0);
+    MultiFab exact(ba, dm, ncomp, 0);
+    {
+        Gpu::DeviceVector<Real> scales_d(ncomp);
+        Gpu::copyAsync(Gpu::hostToDevice, scales.begin(), scales.end(), scales_d.begin());
+        Real const* ps = scales_d.data();
+        const auto problo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        const Real pi = Real(3.141592653589793238462643383279502884197);
+        for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            auto const& r = rhs.array(mfi);
+            auto const& e = exact.array(mfi);
+            amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                Real x = problo[0] + (i+0.5_rt)*dx[0];
+                Real y = problo[1] + (j+0.5_rt)*dx[1];
+                Real kx = Real(n+1)*pi;
+                Real s = ps[n] * std::sin(kx*x) * std::sin(pi*y);
+                Real f = kx*kx + pi*pi;
+#if (AMREX_SPACEDIM == 3)
+                Real z = problo[2] + (k+0.5_rt)*dx[2];
+                s *= std::sin(pi*z);
+                f += pi*pi;
+#else
+                amrex::ignore_unused(k);
+#endif
+                e(i,j,k,n) = s;
+                r(i,j,k,n) = (ascalar + bscalar*f) * s;
+            });
+        }
+        Gpu::streamSynchronize();
+    }
+
+    auto make_linop = [&] (int nc)
+    {
+        auto linop = std::make_unique<MLABecLaplacian>(Vector<Geometry>{geom},
+                                                       Vector<BoxArray>{ba},
+                                                       Vector<DistributionMapping>{dm},
+                                                       LPInfo(), Vector<FabFactory<FArrayBox> const*>{},
+                                                       nc);
+        linop->setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet)},
+                           {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet)});
+        linop->setLevelBC(0, nullptr);
+        linop->setScalars(ascalar, bscalar);
+        linop->setACoeffs(0, 1.0_rt);
+        linop->setBCoeffs(0, 1.0_rt);
+        return linop;
+    };
+
+    // One solve per component
+    MultiFab phi_separate(ba, dm, ncomp, 1);
+    phi_separate.setVal(0.0);
+    double t_separate = amrex::second();
+    for (int n = 0; n < ncomp; ++n) {
+        auto linop = make_linop(1);
+        MultiFab phi(phi_separate, amrex::make_alias, n, 1);
+        MultiFab b(rhs, amrex::make_alias, n, 1);
+        MLMG mlmg(*linop);
+        mlmg.setVerbose(verbose);
+        mlmg.solve({&phi}, {&b}, tol_rel, 0.0);
+    }
+    t_separate = amrex::second() - t_separate;
+
+    // All components in one solve
+    MultiFab phi_batched(ba, dm, ncomp, 1);
+    phi_batched.setVal(0.0);
+    double t_batched = amrex::second();
+    Vector<Real> final_resnorm;
+    {
+        auto linop = make_linop(ncomp);
+        MLMG mlmg(*linop);
+        mlmg.setVerbose(verbose);
+        mlmg.setComponentwiseConvergence(true);
+        mlmg.solve({&phi_batched}, {&rhs}, tol_rel, 0.0);
+        final_resnorm = mlmg.getFinalResidualComp();
+    }
+    t_batched = amrex::second() - t_batched;
+
+    ParallelDescriptor::ReduceRealMax(t_separate);
+    ParallelDescriptor::ReduceRealMax(t_batched);
+    amrex::Print() << "Time of " << ncomp << " separate solves: " << t_separate << "\n"
+                   << "Time of one batched solve: " << t_batched << "\n";
+
+    AMREX_ALWAYS_ASSERT(static_cast<int>(final_resnorm.size()) == ncomp);
+
+    auto error = [&] (MultiFab const& phi, int n)
+    {
+        MultiFab e(ba, dm, 1, 0);
+        MultiFab::LinComb(e, 1._rt, phi, n, -1._rt, exact, n, 0, 1, IntVect(0));
+        return e.norminf(0, 1, IntVect(0));
+    };
+
+    // Every component must converge relative to its own magnitude, and the
+    // two approaches must give the same discretization error.
+    for (int n = 0; n < ncomp; ++n) {
+        const Real rhsnorm = rhs.norminf(n, 1, IntVect(0));
+        const Real err_separate = error(phi_separate, n);
+        const Real err_batched = error(phi_batched, n);
+        amrex::Print() << "Component " << n << ": resid/rhs = " << final_resnorm[n]/rhsnorm
+                       << ", relative error separate = " << err_separate/scales[n]
+                       << ", batched = " << err_batched/scales[n] << "\n";
+        AMREX_ALWAYS_ASSERT(final_resnorm[n] <= tol_rel*rhsnorm);
+        AMREX_ALWAYS_ASSERT(std::abs(err_batched-err_separate) <= 1.e-6_rt*err_separate);
+    }
+}
@@ -0,0 +1,107 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_OpenBC.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    Vector<int> orders{7};
+    Vector<Real> thetas{0.5_rt};
+    Real tolerance = 1.e-4;
+    int verbose = 1;
+    Real tol_rel = 1.e-10;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.queryarr("orders", orders);
+        pp.queryarr("thetas", thetas);
+        pp.query("tolerance", tolerance);
+        pp.query("verbose", verbose);
+        pp.query("tol_rel", tol_rel);
+    }
+    AMREX_ALWAYS_ASSERT(orders.size() == thetas.size());
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({AMREX_D_DECL(0._rt,0._rt,0._rt)}, {AMREX_D_DECL(1._rt,1._rt,1._rt)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    // Two Gaussian blobs of different sizes and signs away from the center,
+    // so that the boundary potential has more than a monopole.
+    MultiFab rhs(ba, dm, 1, 0);
+    {
+        const auto problo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            auto const& r = rhs.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                Real x = problo[0] + (i+0.5_rt)*dx[0];
+                Real y = problo[1] + (j+0.5_rt)*dx[1];
+                Real z = problo[2] + (k+0.5_rt)*dx[2];
+                Real r1 = (x-0.35_rt)*(x-0.35_rt) + (y-0.4_rt)*(y-0.4_rt)
+                    + (z-0.5_rt)*(z-0.5_rt);
+                Real r2 = (x-0.65_rt)*(x-0.65_rt) + (y-0.55_rt)*(y-0.55_rt)
+                    + (z-0.45_rt)*(z-0.45_rt);
+                r(i,j,k) = std::exp(-r1/(0.06_rt*0.06_rt))
+                    - 0.5_rt*std::exp(-r2/(0.04_rt*0.04_rt));
+            });
+        }
+    }
+
+    MultiFab phi_direct(ba, dm, 1, 1);
+    MultiFab phi(ba, dm, 1, 1);
+
+    OpenBCSolver solver({geom}, {ba}, {dm});
+    solver.setVerbose(verbose);
+
+    // The first solve is the reference, and it also sets up the solver.
+    phi_direct.setVal(0.0);
+    solver.solve({&phi_direct}, {&rhs}, tol_rel, 0.0);
+    const Real phi_max = phi_direct.norm0();
+
+    amrex::Print() << "\n  order  theta    rel. error    time\n";
+    for (int icase = -1; icase < orders.size(); ++icase)
+    {
+        // Case -1 is the direct sum again, for its time.
+        const int order = (icase < 0) ? openbc::M : orders[icase];
+        const Real theta = (icase < 0) ? 0._rt : thetas[icase];
+        solver.setMultipoleOrder(order);
+        solver.setOpeningAngle(theta);
+
+        phi.setVal(0.0);
+        ParallelDescriptor::Barrier();
+        Real t0 = amrex::second();
+        solver.solve({&phi}, {&rhs}, tol_rel, 0.0);
+        ParallelDescriptor::Barrier();
+        const Real t = amrex::second() - t0;
+
+        MultiFab::Subtract(phi, phi_direct, 0, 0, 1, 0);
+        const Real error = phi.norm0() / phi_max;
+        amrex::Print() << "  " << order << "      " << theta << "      " << error
+                       << "    " << t << "\n";
+        if (icase < 0) {
+            AMREX_ALWAYS_ASSERT(error == 0.0);
+        } else {
+            AMREX_ALWAYS_ASSERT(error < tolerance);
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include <AMReX.H>
 #include <AMReX_Parser.H>
 #include <AMReX_IParser.H>
+#include <AMReX_Utility.H>
+#include <iomanip>
 #include <map>
 
 using namespace amrex;
@@ -27,12 +29,23 @@ int test1 (std::string const& f,
 
     GpuArray<Real,1> dx{(hi[0]-lo[0]) / (N-1)};
 
+    Vector<double> xs(N), batch(N);
+    for (int i = 0; i < N; ++i) {
+        xs[i] = lo[0] + i*dx[0];
+    }
+    exe.evalBatch(N, {xs.data()}, batch.data());
+
     int nfail = 0;
     Real max_relerror = 0.;
     for (int i = 0; i < N; ++i) {
         Real x = lo[0] + i*dx[0];
         Real result = exe(x);
         Real benchmark = fb(x);
+        if (std::abs(result-batch[i]) > abstol &&
+            std::abs(result-batch[i]) > reltol*std::abs(result)) {
+            amrex::Print() << "\n    batch f(" << x << ") = " << batch[i] << ", " << result;
+            ++nfail;
+        }
         Real abserror = std::abs(result-benchmark);
         Real relerror = abserror / (1.e-50 + std::max(std::abs(result),std::abs(benchmark)));
         if (abserror > abstol && relerror > reltol) {
@@ -72,6 +85,18 @@ int test3 (std::string const& f,
     GpuArray<Real,3> dx{(hi[0]-lo[0]) / (N-1),
                         (hi[1]-lo[1]) / (N-1),
                         (hi[2]-lo[2]) / (N-1)};
+    const int npts = N*N*N;
+    Vector<double> xs(npts), ys(npts), zs(npts), batch(npts);
+    for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+    for (int k = 0; k < N; ++k) {
+        int n = (i*N+j)*N+k;
+        xs[n] = lo[0] + i*dx[0];
+        ys[n] = lo[1] + j*dx[1];
+        zs[n] = lo[2] + k*dx[2];
+    }}}
+    exe.evalBatch(npts, {xs.data(), ys.data(), zs.data()}, batch.data());
+
     int nfail = 0;
     for (int i = 0; i < N; ++i) {
     for (int j = 0; j < N; ++j) {
@@ -81,6 +106,12 @@ int test3 (std::string const& f,
         Real z = lo[2] + k*dx[2];
         Real result = exe(x,y,z);
         Real benchmark = fb(x,y,z);
+        if (std::abs(result-batch[(i*N+j)*N+k]) > abstol &&
+            std::abs(result-batch[(i*N+j)*N+k]) > reltol*std::abs(result)) {
+            amrex::Print() << "    batch f(" << x << "," << y << "," << z << ") = "
+                           << batch[(i*N+j)*N+k] << ", " << result << "\n";
+            ++nfail;
+        }
         Real abserror = std::abs(result-benchmark);
         Real relerror = abserror / (1.e-50 + std::max(std::abs(result),std::abs(benchmark)));
         if (abserror > abstol && relerror > reltol) {
@@ -119,6 +150,20 @@ int test4 (std::string const& f,
                         (hi[1]-lo[1]) / (N-1),
                         (hi[2]-lo[2]) / (N-1),
                         (hi[3]-lo[3]) / (N-1)};
+    const int npts = N*N*N*N;
+    Vector<double> xs(npts), ys(npts), zs(npts), ts(npts), batch(npts);
+    for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+    for (int k = 0; k < N; ++k) {
+    for (int m = 0; m < N; ++m) {
+        int n = ((i*N+j)*N+k)*N+m;
+        xs[n] = lo[0] + i*dx[0];
+        ys[n] = lo[1] + j*dx[1];
+        zs[n] = lo[2] + k*dx[2];
+        ts[n] = lo[3] + m*dx[3];
+    }}}}
+    exe.evalBatch(npts, {xs.data(), ys.data(), zs.data(), ts.data()}, batch.data());
+
     int nfail = 0;
     for (int i = 0; i < N; ++i) {
     for (int j = 0; j < N; ++j) {
@@ -130,6 +175,12 @@ int test4 (std::string const& f,
         Real t = lo[3] + m*dx[3];
         Real result = exe(x,y,z,t);
         Real benchmark = fb(x,y,z,t);
+        if (std::abs(result-batch[((i*N+j)*N+k)*N+m]) > abstol &&
+            std::abs(result-batch[((i*N+j)*N+k)*N+m]) > reltol*std::abs(result)) {
+            amrex::Print() << "    batch f(" << x << "," << y << "," << z << "," << t << ") = "
+                           << batch[((i*N+j)*N+k)*N+m] << ", " << result << "\n";
+            ++nfail;
+        }
         Real abserror = std::abs(result-benchmark);
         Real relerror = abserror / (1.e-50 + std::max(std::abs(result),std::abs(benchmark)));
         if (abserror > abstol && relerror > reltol) {
@@ -147,6 +198,58 @@ int test4 (std::string const& f,
     }
 }
 
+// Points per second of a long expression with repeated subexpressions,
+// with and without common subexpression elimination, evaluated point by
+// point and in batches.
+void benchmark ()
+{
+    std::string const f = "if(sqrt((x-xc)**2+(y-yc)**2+(z-zc)**2) < r0,"
+        " dens*exp(-((x-xc)**2+(y-yc)**2+(z-zc)**2)/(w*w))*cos(k*sqrt((x-xc)**2+(y-yc)**2+(z-zc)**2)),"
+        " dens*exp(-((x-xc)**2+(y-yc)**2+(z-zc)**2)/(w*w))*(1+0.1*sin(k*z)))"
+        " + 0.5*sin(k*x)*cos(k*y) + 0.25*sin(k*x)*cos(k*y)*sin(k*z)";
+    std::map<std::string,Real> const constants
+        {{"xc",0.1}, {"yc",-0.2}, {"zc",0.05}, {"r0",0.5}, {"dens",2.0}, {"w",0.3}, {"k",6.0}};
+
+    constexpr int npts = 1 << 20;
+    Vector<double> xs(npts), ys(npts), zs(npts), r0(npts), r1(npts);
+    for (int n = 0; n < npts; ++n) {
+        xs[n] = -1.0 + 2.0*double(n % 128)/127.;
+        ys[n] = -1.0 + 2.0*double((n/128) % 128)/127.;
+        zs[n] = -1.0 + 2.0*double(n/(128*128))/63.;
+    }
+
+    amrex::Print() << "Benchmark: \"" << f << "\"\n";
+    for (bool cse : {false, true}) {
+        amrex::parser_set_cse(cse);
+        Parser parser(f);
+        for (auto const& kv : constants) {
+            parser.setConstant(kv.first, kv.second);
+        }
+        parser.registerVariables({"x","y","z"});
+        auto const exe = parser.compileHost<3>();
+
+        double t0 = amrex::second();
+        for (int n = 0; n < npts; ++n) {
+            r0[n] = exe(xs[n], ys[n], zs[n]);
+        }
+        double t1 = amrex::second();
+        exe.evalBatch(npts, {xs.data(), ys.data(), zs.data()}, r1.data());
+        double t2 = amrex::second();
+
+        for (int n = 0; n < npts; ++n) {
+            AMREX_ALWAYS_ASSERT(std::abs(r0[n]-r1[n]) <= 1.e-12*std::abs(r0[n]));
+        }
+
+        amrex::Print() << "    CSE " << (cse ? "on " : "off")
+                       << std::fixed << std::setprecision(2)
+                       << "   point by point: " << std::setw(7) << npts/(t1-t0)*1.e-6 << " Mpts/s"
+                       << "   batch: " << std::setw(7) << npts/(t2-t1)*1.e-6 << " Mpts/s\n"
+                       << std::defaultfloat << std::setprecision(6);
+    }
+    amrex::parser_set_cse(true);
+    amrex::Print() << "\n";
+}
+
 int main (int argc, char* argv[])
 {
     amrex::Initialize(argc, argv);
@@ -436,5 +539,7 @@ int main (int argc, char* argv[])
         amrex::Print() << "\nAll IParser tests passed\n\n";
     }
 
+    benchmark();
+
     amrex::Finalize();
 }
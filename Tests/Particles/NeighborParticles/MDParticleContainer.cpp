@@ -4,6 +4,8 @@
 #include "CheckPair.H"
 #include <AMReX_SPACE.H>
 
+#include <algorithm>
+
 using namespace amrex;
 
 namespace
@@ -227,6 +229,95 @@ void MDParticleContainer::moveParticles(amrex::ParticleReal dx)
     }
 }
 
+void MDParticleContainer::randomWalk(amrex::ParticleReal max_step)
+{
+    BL_PROFILE("MDParticleContainer::randomWalk");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    for(MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+
+        auto& ptile = plev[std::make_pair(gid, tid)];
+        auto& aos   = ptile.GetArrayOfStructs();
+        ParticleType* pstruct = aos().dataPtr();
+
+        const size_t np = aos.numParticles();
+
+        amrex::ParallelForRNG( np,
+        [=] AMREX_GPU_DEVICE (int i, RandomEngine const& engine) noexcept
+        {
+            ParticleType& p = pstruct[i];
+            AMREX_D_TERM(p.pos(0) += static_cast<ParticleReal>((2*amrex::Random(engine)-1)*max_step);,
+                         p.pos(1) += static_cast<ParticleReal>((2*amrex::Random(engine)-1)*max_step);,
+                         p.pos(2) += static_cast<ParticleReal>((2*amrex::Random(engine)-1)*max_step);)
+        });
+    }
+}
+
+void MDParticleContainer::checkNeighborListCovers(amrex::Real cutoff)
+{
+    BL_PROFILE("MDParticleContainer::checkNeighborListCovers");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+        auto index = std::make_pair(gid, tid);
+
+        auto& ptile = plev[index];
+        auto& aos   = ptile.GetArrayOfStructs();
+
+        const int np       = aos.numParticles();
+        const int np_total = aos.numTotalParticles();
+
+        amrex::Gpu::HostVector<ParticleType> h_pstruct(np_total);
+        Gpu::copy(Gpu::deviceToHost, aos().dataPtr(), aos().dataPtr() + np_total, h_pstruct.begin());
+
+        auto& d_counts = m_neighbor_list[lev][index].GetCounts();
+        Gpu::HostVector<unsigned int> h_counts(d_counts.size());
+        Gpu::copy(Gpu::deviceToHost, d_counts.begin(), d_counts.end(), h_counts.begin());
+
+        auto& d_list = m_neighbor_list[lev][index].GetList();
+        Gpu::HostVector<unsigned int> h_list(d_list.size());
+        Gpu::copy(Gpu::deviceToHost, d_list.begin(), d_list.end(), h_list.begin());
+
+        // every pair within the cutoff at the current positions has to be in the list
+        // that was built with the skin at the old positions
+        AMREX_ALWAYS_ASSERT(static_cast<int>(h_counts.size()) >= np);
+        unsigned start = 0;
+        for (int i = 0; i < np; ++i)
+        {
+            ParticleType& p1 = h_pstruct[i];
+            auto first = h_list.begin() + start;
+            auto last  = first + h_counts[i];
+            for (int j = 0; j < np_total; ++j)
+            {
+                if (i == j) continue;
+
+                ParticleType& p2 = h_pstruct[j];
+                AMREX_D_TERM(Real dx = p1.pos(0) - p2.pos(0);,
+                             Real dy = p1.pos(1) - p2.pos(1);,
+                             Real dz = p1.pos(2) - p2.pos(2);)
+
+                Real r2 = AMREX_D_TERM(dx*dx, + dy*dy, + dz*dz);
+
+                if (r2 <= cutoff*cutoff)
+                {
+                    AMREX_ALWAYS_ASSERT(std::find(first, last, static_cast<unsigned int>(j)) != last);
+                }
+            }
+            start += h_counts[i];
+        }
+    }
+}
+
 void MDParticleContainer::writeParticles(const int n)
 {
     BL_PROFILE("MDParticleContainer::writeParticles");
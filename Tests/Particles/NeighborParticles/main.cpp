@@ -23,6 +23,8 @@ void testNeighborParticles();
 
 void testNeighborList();
 
+void testVerletSkin();
+
 int main (int argc, char* argv[])
 {
     amrex::Initialize(argc,argv);
@@ -33,6 +35,9 @@ int main (int argc, char* argv[])
     amrex::PrintToFile("neighbor_test") << "Running neighbor list test \n";
     testNeighborList();
 
+    amrex::PrintToFile("neighbor_test") << "Running Verlet skin test \n";
+    testVerletSkin();
+
     amrex::Finalize();
 }
 
@@ -191,3 +196,58 @@ void testNeighborList ()
                              {"dummy"}, geom, 0.0, 0);
     pc.WritePlotFile("NeighborParticles_plt00001", "neighbors");
 }
+
+void testVerletSkin ()
+{
+    BL_PROFILE("testVerletSkin");
+    TestParams params;
+    get_test_params(params, "nbor_list");
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++)
+        is_per[i] = params.is_periodic;
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    // the neighbor cells have to cover cutoff + skin
+    const int ncells = 2;
+    MDParticleContainer pc(geom, dm, ba, ncells);
+
+    int npc = params.num_ppc;
+    IntVect nppc = IntVect(AMREX_D_DECL(npc, npc, npc));
+    pc.InitParticles(nppc, 1.0, 0.0);
+
+    const Real cutoff = 5.0*Params::cutoff;
+    const Real skin = 0.3;
+    pc.setVerletSkin(skin);
+    CheckPairWithSkin check_pair{(cutoff+skin)*(cutoff+skin)};
+
+    const int nsteps = 20;
+    for (int step = 0; step < nsteps; ++step)
+    {
+        pc.buildOrReuseNeighborList(check_pair);
+        pc.checkNeighborListCovers(cutoff);
+        pc.randomWalk(static_cast<amrex::ParticleReal>(0.02));
+    }
+
+    amrex::PrintToFile("neighbor_test") << "Neighbor list built " << pc.numNeighborListBuilds()
+                                        << " times and reused " << pc.numNeighborListReuses()
+                                        << " times in " << nsteps << " steps \n";
+    AMREX_ALWAYS_ASSERT(pc.numNeighborListBuilds() + pc.numNeighborListReuses() == nsteps);
+    AMREX_ALWAYS_ASSERT(pc.numNeighborListBuilds() > 1 && pc.numNeighborListReuses() > 0);
+}
@@ -0,0 +1,146 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include "AMReX_Particles.H"
+#include <AMReX_ParticleMesh.H>
+#include <AMReX_ParticleInterpolators.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int nppc;
+  bool verbose;
+};
+
+void testSortedDeposition (TestParams& parms)
+{
+
+  RealBox real_box;
+  for (int n = 0; n < AMREX_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz-1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[AMREX_SPACEDIM];
+  for (int i = 0; i < AMREX_SPACEDIM; i++)
+    is_per[i] = 1;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  ba.maxSize(parms.max_grid_size);
+
+  DistributionMapping dmap(ba);
+
+  typedef ParticleContainer<1 + 2*AMREX_SPACEDIM, 1> MyParticleContainer;
+  MyParticleContainer myPC(geom, dmap, ba);
+  myPC.SetVerbose(false);
+
+  int num_particles = parms.nppc * parms.nx * parms.ny * parms.nz;
+  if (ParallelDescriptor::IOProcessor())
+    std::cout << "Total number of particles    : " << num_particles << '\n' << '\n';
+
+  bool serialize = true;
+  int iseed = 451;
+  double mass = 10.0;
+
+  MyParticleContainer::ParticleInitData pdata = {{mass, AMREX_D_DECL(1.0, 2.0, 3.0), AMREX_D_DECL(0.0, 0.0, 0.0)}, {},{},{}};
+  myPC.InitRandom(num_particles, iseed, pdata, serialize);
+
+  // Put the particles in cell order in memory, as the sorted deposition expects.
+  myPC.SortParticlesByCell();
+
+  const int nc = 1 + AMREX_SPACEDIM;
+  const auto plo = geom.ProbLoArray();
+  const auto dxi = geom.InvCellSizeArray();
+  auto deposit = [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleTileType::ConstParticleTileDataType& ptd, int i,
+                                       amrex::Array4<amrex::Real> const& rho)
+      {
+          auto p = ptd.m_aos[i];
+          ParticleInterpolator::Linear interp(p, plo, dxi);
+
+          interp.ParticleToMesh(p, rho, 0, 0, 1,
+                      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& part, int comp)
+                      {
+                          return part.rdata(comp);  // no weighting
+                      });
+
+          interp.ParticleToMesh(p, rho, 1, 1, AMREX_SPACEDIM,
+                      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& part, int comp)
+                      {
+                          return part.rdata(0) * p.rdata(comp);  // mass weight these comps
+                      });
+      };
+
+  MultiFab atomicMF(ba, dmap, nc, 1);
+  Real t0 = amrex::second();
+  amrex::ParticleToMesh(myPC, atomicMF, 0, deposit);
+  Real t_atomic = amrex::second() - t0;
+
+  // The sorted deposition must give the same answer up to roundoff, both when it
+  // builds the bins and when it reuses them.
+  SortedDepositionPolicy sorted;
+  MultiFab sortedMF(ba, dmap, nc, 1);
+  Real t_sorted = 0.0;
+  for (int irep = 0; irep < 2; ++irep) {
+      t0 = amrex::second();
+      amrex::ParticleToMesh(myPC, sortedMF, 0, deposit, sorted);
+      t_sorted = amrex::second() - t0;
+
+      MultiFab::Subtract(sortedMF, atomicMF, 0, 0, nc, 0);
+      for (int n = 0; n < nc; ++n) {
+          Real err = sortedMF.norm0(n);
+          Real ref = atomicMF.norm0(n);
+          AMREX_ALWAYS_ASSERT(err <= 1.e-12 * ref);
+      }
+  }
+  AMREX_ALWAYS_ASSERT(sorted.numBinReuses() > 0);
+
+  if (parms.verbose) {
+      ParallelDescriptor::ReduceRealMax(t_atomic);
+      ParallelDescriptor::ReduceRealMax(t_sorted);
+      amrex::Print() << "ParticleToMesh time, atomic: " << t_atomic
+                     << ", sorted with reused bins: " << t_sorted << "\n";
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("nppc", parms.nppc);
+  if (parms.nppc < 1 && ParallelDescriptor::IOProcessor())
+    amrex::Abort("Must specify at least one particle per cell");
+
+  parms.verbose = false;
+  pp.query("verbose", parms.verbose);
+
+  if (parms.verbose && ParallelDescriptor::IOProcessor()) {
+    std::cout << std::endl;
+    std::cout << "Number of particles per cell : ";
+    std::cout << parms.nppc  << std::endl;
+    std::cout << "Size of domain               : ";
+    std::cout << parms.nx << " " << parms.ny << " " << parms.nz << std::endl;
+  }
+
+  testSortedDeposition(parms);
+
+  amrex::Finalize();
+}
@@ -2,6 +2,7 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_Particles.H>
+#include <AMReX_Utility.H>
 
 using namespace amrex;
 
@@ -78,6 +79,16 @@ public:
         Redistribute(lev_min, lev_max, nGrow, local, remove_neg);
     }
 
+    void RedistributeIncremental (bool remove_neg=true)
+    {
+        const int lev_min = 0;
+        const int lev_max = finestLevel();
+        const int nGrow = 0;
+        const int local = 0;
+        ParticleContainer<NSR, NSI, NAR, NAI>::RedistributeIncremental(lev_min, lev_max, nGrow,
+                                                                       local, remove_neg);
+    }
+
     void InitParticles (const amrex::IntVect& a_num_particles_per_cell)
     {
         BL_PROFILE("InitParticles");
@@ -419,6 +430,8 @@ void testRedistribute ()
 
     if (params.sort) pc.SortParticlesByCell();
 
+    Real full_time = 0.0;
+    Long full_bytes = 0;
     for (int i = 0; i < params.nsteps; ++i)
     {
         pc.moveParticles(params.move_dir, params.do_random);
@@ -429,11 +442,46 @@ void testRedistribute ()
             AMREX_ALWAYS_ASSERT(old == pc.TotalNumberOfParticles(false));
             pc.negateEven();
         }
+        Real strt_time = amrex::second();
         pc.RedistributeLocal();
+        full_time += amrex::second() - strt_time;
+        full_bytes += pc.RedistributeBytesSent();
         if (params.sort) pc.SortParticlesByCell();
         pc.checkAnswer();
     }
 
+    // The same moves again, with the fast path that only locates the particles that left
+    // their tile.
+    Real incr_time = 0.0;
+    Long incr_bytes = 0;
+    for (int i = 0; i < params.nsteps; ++i)
+    {
+        pc.moveParticles(params.move_dir, params.do_random);
+        if (!remove_negative) {
+            auto old = pc.TotalNumberOfParticles();
+            pc.negateEven();
+            pc.RedistributeIncremental(false);
+            AMREX_ALWAYS_ASSERT(old == pc.TotalNumberOfParticles(false));
+            pc.negateEven();
+        }
+        Real strt_time = amrex::second();
+        pc.RedistributeIncremental();
+        incr_time += amrex::second() - strt_time;
+        incr_bytes += pc.RedistributeBytesSent();
+        if (params.sort) pc.SortParticlesByCell();
+        pc.checkAnswer();
+    }
+
+    if (geom[0].isAllPeriodic()) AMREX_ALWAYS_ASSERT(np_old == pc.TotalNumberOfParticles());
+
+    ParallelDescriptor::ReduceRealMax(full_time);
+    ParallelDescriptor::ReduceRealMax(incr_time);
+    ParallelDescriptor::ReduceLongSum(full_bytes);
+    ParallelDescriptor::ReduceLongSum(incr_bytes);
+    amrex::Print() << "Redistribute over " << params.nsteps << " steps:\n"
+                   << "  full:        " << full_time << " s, " << full_bytes << " bytes sent\n"
+                   << "  incremental: " << incr_time << " s, " << incr_bytes << " bytes sent\n";
+
     if (params.do_regrid)
     {
         const int NProcs = ParallelDescriptor::NProcs();
@@ -0,0 +1,130 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <cmath>
+#include <string>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+void main_main ()
+{
+    BL_PROFILE("main");
+
+    int n_cell = 64;
+    int max_grid_size = 16;
+    int nreads = 2;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nreads", nreads);
+    }
+
+    const Box domain(IntVect(0), IntVect(n_cell-1));
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+
+    const Vector<std::string> varnames{"a", "b", "c", "d"};
+    const int ncomp = varnames.size();
+    MultiFab mf(ba, dm, ncomp, 0);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = std::sin(Real(0.1)*i + n) + Real(0.01)*j*k;
+        });
+    }
+
+    // Check the region reads against the data in mf.
+    auto check = [&] (MultiFab const& region_mf, Vector<int> const& comps,
+                      std::string const& label)
+    {
+        MultiFab ref(region_mf.boxArray(), region_mf.DistributionMap(), comps.size(), 0);
+        for (int n = 0; n < comps.size(); ++n) {
+            ref.ParallelCopy(mf, comps[n], n, 1);
+        }
+        MultiFab::Subtract(ref, region_mf, 0, 0, comps.size(), 0);
+        Real max_diff = ref.norm0(0, comps.size(), IntVect(0));
+        amrex::Print() << "  " << label << " cells: " << region_mf.boxArray().numPts()
+                       << "  max diff: " << max_diff << "\n";
+        AMREX_ALWAYS_ASSERT(max_diff == Real(0.0));
+    };
+
+    const std::string pltfile = "plt_region";
+
+    for (auto version : {VisMF::Header::Version_v1, VisMF::Header::NoFabHeader_v1,
+                         VisMF::Header::Compressed_v1})
+    {
+        VisMF::SetHeaderVersion(version);
+        WriteSingleLevelPlotfile(pltfile, mf, varnames, geom, Real(0.0), 0);
+
+        PlotFileData pf(pltfile);
+        for (bool mapped : {false, true}) {
+            pf.setMemoryMapped(mapped);
+            amrex::Print() << "Header version " << version
+                           << (mapped ? ", memory mapped\n" : ", streams\n");
+
+            Box zslice = domain;
+            zslice.setSmall(AMREX_SPACEDIM-1, n_cell/3);
+            zslice.setBig(AMREX_SPACEDIM-1, n_cell/3);
+            check(pf.get(0, zslice, {"c", "a"}), {2, 0}, "z-slice  ");
+
+            Box xslice = domain;
+            xslice.setSmall(0, n_cell/2+1);
+            xslice.setBig(0, n_cell/2+1);
+            check(pf.get(0, xslice, {"d"}), {3}, "x-slice  ");
+
+            Box small(IntVect(5), IntVect(n_cell/2+3));
+            check(pf.get(0, small, {"b", "c", "d"}), {1, 2, 3}, "small box");
+
+            RealBox region({AMREX_D_DECL(0.1,0.2,0.3)}, {AMREX_D_DECL(0.4,0.45,0.35)});
+            check(pf.get(0, region, varnames), {0, 1, 2, 3}, "real box ");
+
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                FArrayBox fab = pf.getFab(0, mfi.index(), "b");
+                fab.minus<RunOn::Host>(mf[mfi], 1, 0, 1);
+                AMREX_ALWAYS_ASSERT(fab.norm<RunOn::Host>(0, 0, 1) == Real(0.0));
+            }
+        }
+
+        // Timing of a slice against reading the whole variable.
+        for (int iread = 0; iread < nreads; ++iread) {
+            for (bool mapped : {false, true}) {
+                pf.setMemoryMapped(mapped);
+                double t0 = amrex::second();
+                MultiFab whole = pf.get(0, "c");
+                double t_whole = amrex::second() - t0;
+                Box zslice = domain;
+                zslice.setSmall(AMREX_SPACEDIM-1, n_cell/2);
+                zslice.setBig(AMREX_SPACEDIM-1, n_cell/2);
+                t0 = amrex::second();
+                MultiFab slice = pf.get(0, zslice, {"c"});
+                double t_slice = amrex::second() - t0;
+                ParallelDescriptor::ReduceRealMax(t_whole);
+                ParallelDescriptor::ReduceRealMax(t_slice);
+                amrex::Print() << "  " << (mapped ? "mapped " : "streams")
+                               << " read time, whole variable: " << t_whole
+                               << "  z-slice: " << t_slice << "\n";
+            }
+        }
+        ParallelDescriptor::Barrier();
+    }
+}
@@ -0,0 +1,227 @@
+#include <AMReX.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Random.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <string>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// Known-answer vectors for Philox4x32-10 from the Random123 distribution.
+void test_known_answers ()
+{
+    struct KAT {
+        GpuArray<std::uint32_t,4> ctr;
+        GpuArray<std::uint32_t,2> key;
+        GpuArray<std::uint32_t,4> expected;
+    };
+    KAT const kats[] = {
+        {{0x00000000U, 0x00000000U, 0x00000000U, 0x00000000U},
+         {0x00000000U, 0x00000000U},
+         {0x6627e8d5U, 0xe169c58dU, 0xbc57ac4cU, 0x9b00dbd8U}},
+        {{0xffffffffU, 0xffffffffU, 0xffffffffU, 0xffffffffU},
+         {0xffffffffU, 0xffffffffU},
+         {0x408f276dU, 0x41c83b0eU, 0xa20bc7c6U, 0x6d5451fdU}},
+        {{0x243f6a88U, 0x85a308d3U, 0x13198a2eU, 0x03707344U},
+         {0xa4093822U, 0x299f31d0U},
+         {0xd16cfe09U, 0x94fdccebU, 0x5001e420U, 0x24126ea1U}}
+    };
+    for (auto const& kat : kats) {
+        auto r = Philox4x32x10(kat.ctr, kat.key);
+        for (int i = 0; i < 4; ++i) {
+            AMREX_ALWAYS_ASSERT(r[i] == kat.expected[i]);
+        }
+    }
+}
+
+// FillRandom must reproduce the sequential draws of the same stream.
+void test_batch_matches_sequential ()
+{
+    constexpr Long n = 1001;
+    Vector<Real> batch(n);
+    FillRandom(batch.data(), n, 42, 7, 3);
+    PhiloxEngine engine(42, 7, 3);
+    for (Long i = 0; i < n; ++i) {
+        AMREX_ALWAYS_ASSERT(batch[i] == Random(engine));
+        AMREX_ALWAYS_ASSERT(batch[i] >= Real(0.0) && batch[i] < Real(1.0));
+    }
+}
+
+// Draws keyed on an element id do not depend on the order of evaluation.
+void test_order_independence ()
+{
+    constexpr int n = 10000;
+    Vector<Real> fwd(n), bwd(n);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < n; ++i) {
+        PhiloxEngine engine(1234, i, 5);
+        fwd[i] = RandomNormal(Real(0.0), Real(1.0), engine);
+    }
+    for (int i = n-1; i >= 0; --i) {
+        PhiloxEngine engine(1234, i, 5);
+        bwd[i] = RandomNormal(Real(0.0), Real(1.0), engine);
+    }
+    for (int i = 0; i < n; ++i) {
+        AMREX_ALWAYS_ASSERT(fwd[i] == bwd[i]);
+    }
+
+    // Different steps and seeds give different streams.
+    PhiloxEngine e0(1234, 0, 5), e1(1234, 0, 6), e2(1235, 0, 5);
+    Real r0 = Random(e0), r1 = Random(e1), r2 = Random(e2);
+    AMREX_ALWAYS_ASSERT(r0 != r1 && r0 != r2 && r1 != r2);
+}
+
+void check_moments (std::string const& name, Vector<Real> const& v,
+                    Real mean, Real var)
+{
+    const auto n = static_cast<Real>(v.size());
+    Real s = 0, s2 = 0;
+    for (auto x : v) { s += x; }
+    Real m = s/n;
+    for (auto x : v) { s2 += (x-m)*(x-m); }
+    Real vv = s2/(n-1);
+    amrex::Print() << "  " << std::setw(16) << std::left << name << std::right
+                   << " mean " << std::setw(12) << m << " (" << mean << ")"
+                   << "  var " << std::setw(12) << vv << " (" << var << ")\n";
+    // Five standard errors of the mean, and a loose bound for the variance.
+    AMREX_ALWAYS_ASSERT(std::abs(m-mean) < Real(5.0)*std::sqrt(var/n));
+    AMREX_ALWAYS_ASSERT(std::abs(vv-var) < Real(0.02)*var);
+}
+
+void test_distributions ()
+{
+    constexpr int n = 200000;
+    Vector<Real> v(n);
+
+    amrex::Print() << "Distributions:\n";
+
+    FillRandom(v.data(), n, 11, 0);
+    check_moments("uniform", v, Real(0.5), Real(1.0/12.0));
+
+    FillRandomNormal(v.data(), n, Real(1.0), Real(2.0), 11, 1);
+    check_moments("normal (batch)", v, Real(1.0), Real(4.0));
+
+    PhiloxEngine engine(11, 2);
+    for (auto& x : v) { x = RandomNormal(Real(-1.0), Real(0.5), engine); }
+    check_moments("normal", v, Real(-1.0), Real(0.25));
+
+    for (Real lambda : {Real(0.5), Real(4.0), Real(40.0), Real(1000.0)}) {
+        for (auto& x : v) { x = static_cast<Real>(RandomPoisson(lambda, engine)); }
+        check_moments("poisson", v, lambda, lambda);
+    }
+
+    for (auto& x : v) { x = static_cast<Real>(Random_int(7, engine)); }
+    for (auto x : v) { AMREX_ALWAYS_ASSERT(x >= Real(0.0) && x < Real(7.0)); }
+    check_moments("int [0,7)", v, Real(3.0), Real(4.0));
+}
+
+template <typename F>
+double best_time (int nrep, F&& f)
+{
+    double tbest = std::numeric_limits<double>::max();
+    for (int irep = 0; irep < nrep; ++irep) {
+        double t0 = amrex::second();
+        f();
+        tbest = std::min(tbest, amrex::second()-t0);
+    }
+    return tbest;
+}
+
+void benchmark (Long n, int nrep)
+{
+    Vector<Real> v(n);
+    Real sink = 0;
+
+    auto report = [&] (std::string const& name, double t) {
+        amrex::Print() << "  " << std::setw(28) << std::left << name << std::right
+                       << std::setw(10) << std::fixed << std::setprecision(1)
+                       << static_cast<double>(n)/t*1.e-6 << " M/s\n"
+                       << std::defaultfloat << std::setprecision(6);
+    };
+
+    amrex::Print() << "Throughput for " << n << " variates (best of " << nrep << "):\n";
+
+    report("mt19937 Random", best_time(nrep, [&] () {
+        for (Long i = 0; i < n; ++i) { v[i] = amrex::Random(); }
+    }));
+    report("Philox Random", best_time(nrep, [&] () {
+        PhiloxEngine engine(1, 0);
+        for (Long i = 0; i < n; ++i) { v[i] = amrex::Random(engine); }
+    }));
+    report("Philox per-id Random", best_time(nrep, [&] () {
+        for (Long i = 0; i < n; ++i) {
+            PhiloxEngine engine(1, i);
+            v[i] = amrex::Random(engine);
+        }
+    }));
+    report("Philox FillRandom", best_time(nrep, [&] () {
+        FillRandom(v.data(), n, 1, 0);
+    }));
+    sink += v[n/2];
+
+    report("mt19937 RandomNormal", best_time(nrep, [&] () {
+        for (Long i = 0; i < n; ++i) { v[i] = amrex::RandomNormal(0., 1.); }
+    }));
+    report("Philox RandomNormal", best_time(nrep, [&] () {
+        PhiloxEngine engine(1, 0);
+        for (Long i = 0; i < n; ++i) { v[i] = amrex::RandomNormal(0., 1., engine); }
+    }));
+    report("Philox FillRandomNormal", best_time(nrep, [&] () {
+        FillRandomNormal(v.data(), n, 0., 1., 1, 0);
+    }));
+    sink += v[n/2];
+
+    report("mt19937 RandomPoisson(4)", best_time(nrep, [&] () {
+        for (Long i = 0; i < n; ++i) { v[i] = amrex::RandomPoisson(4.); }
+    }));
+    report("Philox RandomPoisson(4)", best_time(nrep, [&] () {
+        PhiloxEngine engine(1, 0);
+        for (Long i = 0; i < n; ++i) { v[i] = amrex::RandomPoisson(4., engine); }
+    }));
+    sink += v[n/2];
+
+    amrex::Print() << "  (checksum " << sink << ")\n";
+}
+
+}
+
+void main_main ()
+{
+    Long n = 4*1024*1024;
+    int nrep = 3;
+    {
+        ParmParse pp;
+        pp.query("n", n);
+        pp.query("nrep", nrep);
+    }
+
+    test_known_answers();
+    test_batch_matches_sequential();
+    test_order_independence();
+    test_distributions();
+
+    benchmark(n, nrep);
+
+    amrex::Print() << "Random test passed\n";
+}
@@ -0,0 +1,157 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
+#include <AMReX_Random.H>
+#include <AMReX_VisMF.H>
+
+#include <cmath>
+#include <memory>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+void main_main ()
+{
+    BL_PROFILE("main");
+
+    int n_cell = 64;
+    int max_grid_size = 16;
+    int ncomp = 3;
+    int ngrow = 1;
+    int nreads = 2;
+    std::string mf_name = "vismf_read_mf";
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("ncomp", ncomp);
+        pp.query("ngrow", ngrow);
+        pp.query("nreads", nreads);
+        pp.query("mf_name", mf_name);
+    }
+
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    MultiFab mf(ba, dm, ncomp, ngrow);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelForRNG(mfi.fabbox(), ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n, RandomEngine const& engine) noexcept
+        {
+            a(i,j,k,n) = amrex::Random(engine);
+        });
+    }
+
+    // A smooth field compresses much better than random numbers.
+    MultiFab mf_smooth(ba, dm, ncomp, ngrow);
+    for (MFIter mfi(mf_smooth); mfi.isValid(); ++mfi) {
+        auto const& a = mf_smooth.array(mfi);
+        const Real dx = Real(1.0) / n_cell;
+        amrex::ParallelFor(mfi.fabbox(), ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            Real x = (i+Real(0.5))*dx, y = (j+Real(0.5))*dx, z = (k+Real(0.5))*dx;
+            a(i,j,k,n) = (n == 0) ? Real(1.0)
+                : std::sin(Real(6.0)*x + n) * std::cos(Real(4.0)*y) + Real(0.1)*z*z;
+        });
+    }
+
+    // Read into a different distribution so that the data has to move.
+    Vector<int> pmap = dm.ProcessorMap();
+    std::reverse(pmap.begin(), pmap.end());
+    DistributionMapping dm_read(std::move(pmap));
+
+    auto check = [&] (MultiFab const& mf_read, MultiFab const& mf_orig,
+                      std::string const& label, Real tol)
+    {
+        MultiFab diff(ba, dm_read, ncomp, ngrow);
+        diff.Redistribute(mf_orig, 0, 0, ncomp, IntVect(ngrow));
+        MultiFab::Subtract(diff, mf_read, 0, 0, ncomp, ngrow);
+        Real max_diff = diff.norm0(0, ncomp, IntVect(ngrow));
+        amrex::Print() << label << " max diff: " << max_diff << "\n";
+        AMREX_ALWAYS_ASSERT(max_diff <= tol);
+    };
+
+    auto write_and_read = [&] (MultiFab const& mf_orig, VisMF::Header::Version version,
+                               Real tol, std::string const& label)
+    {
+        VisMF::SetHeaderVersion(version);
+        VisMF::SetCompressionTolerance(tol);
+        double t0 = amrex::second();
+        Long nbytes = VisMF::Write(mf_orig, mf_name);
+        double t = amrex::second() - t0;
+        ParallelDescriptor::ReduceLongSum(nbytes);
+        ParallelDescriptor::ReduceRealMax(t);
+        amrex::Print() << label << " write: " << nbytes << " bytes in " << t << " s\n";
+
+        for (int iread = 0; iread < nreads; ++iread) {
+            for (bool aggregated : {false, true}) {
+                VisMF::SetUseAggregatedReads(aggregated);
+                VisMF::SetNReaders(aggregated ? iread+1 : 0);
+                MultiFab mf_read(ba, dm_read, ncomp, ngrow);
+                t0 = amrex::second();
+                VisMF::Read(mf_read, mf_name);
+                t = amrex::second() - t0;
+                ParallelDescriptor::ReduceRealMax(t);
+                std::string read_label = label + (aggregated ? " aggregated" : " default   ");
+                amrex::Print() << read_label << " read time: " << t << " s\n";
+                check(mf_read, mf_orig, read_label, tol);
+            }
+        }
+
+        // Read single components of single fabs.
+        VisMF vismf(mf_name);
+        for (MFIter mfi(mf_orig); mfi.isValid(); ++mfi) {
+            for (int n = 0; n < ncomp; ++n) {
+                std::unique_ptr<FArrayBox> fab(vismf.readFAB(mfi.index(), n));
+                FArrayBox orig(mfi.fabbox(), 1);
+                orig.copy<RunOn::Host>(mf_orig[mfi], n, 0, 1);
+                orig.minus<RunOn::Host>(*fab, 0, 0, 1);
+                AMREX_ALWAYS_ASSERT(orig.norm<RunOn::Host>(0, 0, 1) <= tol);
+            }
+        }
+        return nbytes;
+    };
+
+    write_and_read(mf, VisMF::Header::NoFabHeader_v1, Real(0.0), "Random            ");
+    write_and_read(mf, VisMF::Header::Compressed_v1, Real(0.0), "Random lossless   ");
+
+    Long raw = write_and_read(mf_smooth, VisMF::Header::NoFabHeader_v1, Real(0.0),
+                              "Smooth            ");
+    Long lossless = write_and_read(mf_smooth, VisMF::Header::Compressed_v1, Real(0.0),
+                                   "Smooth lossless   ");
+    Long bounded = write_and_read(mf_smooth, VisMF::Header::Compressed_v1, Real(1.e-6),
+                                  "Smooth tol=1e-6   ");
+    amrex::Print() << "Compression ratio, lossless: " << double(raw)/double(lossless)
+                   << ", error-bounded: " << double(raw)/double(bounded) << "\n";
+    AMREX_ALWAYS_ASSERT(lossless < raw && bounded < lossless);
+
+    // Plotfile headers without data must be readable in the compressed format too.
+    {
+        VisMF::SetHeaderVersion(VisMF::Header::Compressed_v1);
+        Geometry geom(ba.minimalBox(), RealBox(AMREX_D_DECL(0.,0.,0.),AMREX_D_DECL(1.,1.,1.)),
+                      CoordSys::cartesian, Array<int,AMREX_SPACEDIM>{AMREX_D_DECL(0,0,0)});
+        Vector<std::string> varnames;
+        for (int n = 0; n < ncomp; ++n) {
+            varnames.push_back("comp" + std::to_string(n));
+        }
+        std::string plotfile = mf_name + "_plt";
+        WriteMultiLevelPlotfileHeaders(plotfile, 1, {&mf}, varnames, {geom}, Real(0.0),
+                                       {0}, {});
+        VisMF vismf(MultiFabFileFullPrefix(0, plotfile));
+        AMREX_ALWAYS_ASSERT(vismf.nComp() == 0 && vismf.size() == ba.size());
+        amrex::Print() << "Compressed plotfile headers read back\n";
+    }
+}
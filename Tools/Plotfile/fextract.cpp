@@ -217,64 +217,43 @@ void main_main()
 
         Array<Real,AMREX_SPACEDIM> dx = pf.cellSize(ilev);
 
+        IntVect ratio{1};
         if (ilev < fine_level) {
-            IntVect ratio{pf.refRatio(ilev)};
+            ratio = IntVect{pf.refRatio(ilev)};
             for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
                 ratio[idim] = 1;
             }
-            const iMultiFab mask = makeFineMask(pf.boxArray(ilev), pf.DistributionMap(ilev),
-                                                pf.boxArray(ilev+1), ratio);
-            for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                    const Box& bx = mfi.validbox() & slice_box;
-                    if (bx.ok()) {
-                        const auto& m = mask.array(mfi);
-                        const auto& fab = mf.array(mfi);
-                        const auto lo = amrex::lbound(bx);
-                        const auto hi = amrex::ubound(bx);
-                        for         (int k = lo.z; k <= hi.z; ++k) {
-                            for     (int j = lo.y; j <= hi.y; ++j) {
-                                for (int i = lo.x; i <= hi.x; ++i) {
-                                    if (m(i,j,k) == 0) { // not covered by fine
-                                        if (pos.size() == data[ivar].size()) {
-                                            Array<Real,AMREX_SPACEDIM> p
-                                                = {AMREX_D_DECL(problo[0]+static_cast<Real>(i+0.5)*dx[0],
-                                                                problo[1]+static_cast<Real>(j+0.5)*dx[1],
-                                                                problo[2]+static_cast<Real>(k+0.5)*dx[2])};
-                                            pos.push_back(p[idir]);
-                                        }
-                                        data[ivar].push_back(fab(i,j,k));
-                                    }
-                                }
-                            }
+        }
+        rr *= ratio;
+
+        // Only the grids that intersect the slice are read.
+        const MultiFab& mf = pf.get(ilev, slice_box & pf.probDomain(ilev), var_names);
+        if (mf.empty()) { continue; }
+
+        const bool has_mask = ilev < fine_level;
+        iMultiFab mask;
+        if (has_mask) {
+            mask = makeFineMask(mf.boxArray(), mf.DistributionMap(), pf.boxArray(ilev+1), ratio);
+        }
+
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            const auto& fab = mf.array(mfi);
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            for         (int k = lo.z; k <= hi.z; ++k) {
+                for     (int j = lo.y; j <= hi.y; ++j) {
+                    for (int i = lo.x; i <= hi.x; ++i) {
+                        if (has_mask && mask[mfi](IntVect(AMREX_D_DECL(i,j,k))) != 0) {
+                            continue; // covered by fine
                         }
-                    }
-                }
-            }
-            rr *= ratio;
-        } else {
-            for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                    const Box& bx = mfi.validbox() & slice_box;
-                    if (bx.ok()) {
-                        const auto& fab = mf.array(mfi);
-                        const auto lo = amrex::lbound(bx);
-                        const auto hi = amrex::ubound(bx);
-                        for         (int k = lo.z; k <= hi.z; ++k) {
-                            for     (int j = lo.y; j <= hi.y; ++j) {
-                                for (int i = lo.x; i <= hi.x; ++i) {
-                                    if (pos.size() == data[ivar].size()) {
-                                        Array<Real,AMREX_SPACEDIM> p
-                                            = {AMREX_D_DECL(problo[0]+static_cast<Real>(i+0.5)*dx[0],
-                                                            problo[1]+static_cast<Real>(j+0.5)*dx[1],
-                                                            problo[2]+static_cast<Real>(k+0.5)*dx[2])};
-                                        pos.push_back(p[idir]);
-                                    }
-                                    data[ivar].push_back(fab(i,j,k));
-                                }
-                            }
+                        Array<Real,AMREX_SPACEDIM> p
+                            = {AMREX_D_DECL(problo[0]+static_cast<Real>(i+0.5)*dx[0],
+                                            problo[1]+static_cast<Real>(j+0.5)*dx[1],
+                                            problo[2]+static_cast<Real>(k+0.5)*dx[2])};
+                        pos.push_back(p[idir]);
+                        for (int ivar = 0; ivar < var_names.size(); ++ivar) {
+                            data[ivar].push_back(fab(i,j,k,ivar));
                         }
                     }
                 }
@@ -47,13 +47,21 @@ class FullProfile(object):
         del self.lines[0:excl_count + 5]
         incl_count = self.parse_section_of_profiling_output("incl")
 
+        # The hardware counter section is only there with tiny_profiler.perf_counters = 1
+        hw_count = 0
+        del self.lines[0:incl_count + 2]
+        if len(self.lines) > 2 and "IPC Avg" in self.lines[1]:
+            has_flops = "GFLOPS Avg" in self.lines[1]
+            del self.lines[0:3]
+            hw_count = self.parse_counter_section_of_profiling_output(has_flops)
+
         self.profile_dicts.append({
             "frame" : {"name" : "function_profiles"},
             "metrics" : {},
             "children" : self.function_profiles
         })
 
-        total_count = excl_count + incl_count
+        total_count = excl_count + incl_count + hw_count
 
         print(f"Finished parsing profile output! Parsed {total_count} profiling strings.")
 
@@ -111,6 +119,51 @@ class FullProfile(object):
 
         return count
 
+    def parse_counter_section_of_profiling_output(self, has_flops):
+        '''
+        Parses the hardware counter section of the TinyProfiler output
+
+        Parameters
+        ----------
+
+        has_flops (bool): Whether the section has the GFLOPS columns.
+
+        Returns
+        -------
+
+        The number of lines that were parsed
+        '''
+        metric_names = ["n_calls", "instructions_avg",
+                        "ipc_min", "ipc_avg", "ipc_max",
+                        "gbs_min", "gbs_avg", "gbs_max"]
+        if has_flops:
+            metric_names += ["gflops_min", "gflops_avg", "gflops_max"]
+        nvalues = len(metric_names)
+
+        count = 0
+
+        for line in self.lines:
+            if "------" in line:
+                break
+            # these lines are of the form "Function()  ncalls  instructions  ipc_min ..."
+            line = re.sub(" +", " ", line)
+            values = line.split(" ")
+
+            metrics = {}
+            for name, value in zip(metric_names, values[-nvalues:]):
+                metrics[name] = int(value) if name == "n_calls" else float(value)
+            name = "_".join(values[0:-nvalues])
+
+            dict = {
+                "frame" : {"name" : name},
+                "metrics" : metrics
+            }
+
+            self.function_profiles.append(dict)
+            count = count + 1
+
+        return count
+
     def write_file(self):
         if not self.profile_dicts:
             raise RuntimeError("write_file called before profile data was parsed!")